@@ -0,0 +1,100 @@
+#include "barrier.h"
+#include "heap.h"
+
+/*---------------------------------------------------------------------------
+ *  创建屏障
+ *---------------------------------------------------------------------------*/
+BarrierHandle_t xBarrierCreate(uint32_t uxParties)
+{
+    Barrier_t *pxBarrier;
+
+    if (uxParties == 0)
+        return NULL;
+
+    pxBarrier = (Barrier_t *)pvPortMalloc(sizeof(Barrier_t));
+    if (pxBarrier == NULL)
+        return NULL;
+
+    pxBarrier->uxParties = uxParties;
+    pxBarrier->uxArrived = 0;
+    pxBarrier->uxGeneration = 0;
+    vListInit(&(pxBarrier->xTasksWaiting));
+
+    return pxBarrier;
+}
+
+/*---------------------------------------------------------------------------
+ *  删除屏障
+ *---------------------------------------------------------------------------*/
+void vBarrierDelete(BarrierHandle_t xBarrier)
+{
+    vPortFree(xBarrier);
+}
+
+/*---------------------------------------------------------------------------
+ *  到达屏障（带阻塞）
+ *---------------------------------------------------------------------------*/
+int32_t xBarrierWait(BarrierHandle_t xBarrier, uint32_t xTicksToWait)
+{
+    Barrier_t *pxBarrier = (Barrier_t *)xBarrier;
+    uint32_t uxGeneration;
+    uint32_t xSwitchRequired = 0;
+    int32_t xReturn;
+
+    taskENTER_CRITICAL();
+
+    /* 最后一个到达：开始新的一轮，一次遍历放出所有等待的任务，最多触发一次 PendSV */
+    if (pxBarrier->uxArrived + 1 >= pxBarrier->uxParties)
+    {
+        pxBarrier->uxArrived = 0;
+        pxBarrier->uxGeneration++;
+
+        while (pxBarrier->xTasksWaiting.uxNumberOfItems > 0)
+        {
+            xSwitchRequired |= xTaskRemoveFromEventList(&(pxBarrier->xTasksWaiting));
+        }
+
+        if (xSwitchRequired)
+        {
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+        }
+
+        taskEXIT_CRITICAL();
+        return 1;
+    }
+
+    /* 不等待就不算到达 */
+    if (xTicksToWait == 0)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    pxBarrier->uxArrived++;
+    uxGeneration = pxBarrier->uxGeneration;
+
+    vTaskPlaceOnEventList(&(pxBarrier->xTasksWaiting), xTicksToWait);
+
+    taskEXIT_CRITICAL();
+
+    /* 触发切换，被放行或超时后从这里继续 */
+    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+    taskENTER_CRITICAL();
+
+    if (pxBarrier->uxGeneration != uxGeneration)
+    {
+        /* 代数变了：这一轮已经凑齐放行 */
+        xReturn = 0;
+    }
+    else
+    {
+        /* 超时：撤销自己的到达，这一轮还要再凑齐 uxParties 个 */
+        pxBarrier->uxArrived--;
+        xReturn = -1;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
\ No newline at end of file
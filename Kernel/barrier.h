@@ -0,0 +1,49 @@
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <stdint.h>
+#include "queue.h"
+#include "task.h"
+
+/*---------------------------------------------------------------------------
+ *  屏障结构
+ *
+ *  uxParties 个任务都到达后一起放行，最后到达的任务一次把其他任务全部放回就绪链表。
+ *  等待直接用 TCB 里的 xEventListItem，不需要为每个等待者分配内存；
+ *  每放行一次代数加一，屏障可以反复使用，等待者据此区分被放行还是超时
+ *---------------------------------------------------------------------------*/
+typedef struct Barrier
+{
+    uint32_t uxParties;    /* 每一轮需要到达的任务数 */
+    uint32_t uxArrived;    /* 本轮已经到达的任务数 */
+    uint32_t uxGeneration; /* 代数，每放行一次加一 */
+    List_t xTasksWaiting;  /* 本轮已到达、正在等的任务，按优先级排序 */
+} Barrier_t;
+
+typedef Barrier_t *BarrierHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建屏障
+ *   uxParties : 每一轮需要到达的任务数（>= 1）
+ *   返回      : 句柄，失败返回 NULL
+ */
+BarrierHandle_t xBarrierCreate(uint32_t uxParties);
+
+/*
+ * 删除屏障，调用前不能再有任务等在上面
+ */
+void vBarrierDelete(BarrierHandle_t xBarrier);
+
+/*
+ * 到达屏障并等其他任务
+ *   xTicksToWait : 最多等多少 tick
+ *   返回         : 1 自己是最后到达的（放行了这一轮，可以用来做每轮一次的收尾工作），
+ *                  0 被放行，-1 超时（本次到达被撤销，不影响这一轮继续凑齐）
+ */
+int32_t xBarrierWait(BarrierHandle_t xBarrier, uint32_t xTicksToWait);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "condvar.h"
+#include "heap.h"
+
+/*
+ * 被 Signal/Broadcast 唤醒时写进等待任务的 xEventListItem.xItemValue，
+ * 按优先级排序的值最大只有 MAX_PRIORITIES - 1，不会冲突；
+ * 超时唤醒不改它，醒来后据此区分是被唤醒还是超时
+ */
+#define condvarSIGNALLED 0xFFFFFFFFUL
+
+/*---------------------------------------------------------------------------
+ *  创建条件变量
+ *---------------------------------------------------------------------------*/
+CondVarHandle_t xCondVarCreate(void)
+{
+    CondVar_t *pxCondVar;
+
+    pxCondVar = (CondVar_t *)pvPortMalloc(sizeof(CondVar_t));
+    if (pxCondVar == NULL)
+        return NULL;
+
+    vListInit(&(pxCondVar->xTasksWaiting));
+
+    return pxCondVar;
+}
+
+/*---------------------------------------------------------------------------
+ *  删除条件变量
+ *---------------------------------------------------------------------------*/
+void vCondVarDelete(CondVarHandle_t xCondVar)
+{
+    vPortFree(xCondVar);
+}
+
+/*---------------------------------------------------------------------------
+ *  等待条件（带阻塞）
+ *---------------------------------------------------------------------------*/
+int32_t xCondVarWait(CondVarHandle_t xCondVar, MutexHandle_t xMutex, uint32_t xTicksToWait)
+{
+    CondVar_t *pxCondVar = (CondVar_t *)xCondVar;
+    uint32_t xSignalled = 0;
+
+    taskENTER_CRITICAL();
+
+    /* 没有持有互斥量就不能等 */
+    if (xMutex->pxOwner != pxCurrentTCB)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    /*
+     * 先解锁（恢复继承来的优先级，放出一个等锁的任务），再按恢复后的优先级阻塞。
+     * 两步在同一个临界区里，Signal 不会落在解锁和阻塞之间丢掉
+     */
+    (void)xMutexGive(xMutex);
+
+    if (xTicksToWait != 0)
+    {
+        vTaskPlaceOnEventList(&(pxCondVar->xTasksWaiting), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        /* 触发切换，被唤醒或超时后从这里继续 */
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        taskENTER_CRITICAL();
+        xSignalled = (pxCurrentTCB->xEventListItem.xItemValue == condvarSIGNALLED);
+    }
+
+    taskEXIT_CRITICAL();
+
+    /* 重新加锁，锁被别人持有时照常做优先级继承；不管等待是否超时都要拿回锁 */
+    (void)xMutexTake(xMutex, portMAX_DELAY);
+
+    return xSignalled ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------------
+ *  唤醒等待链表头部（优先级最高）的任务（内部函数，必须在临界区内调用）
+ *
+ *  返回 1 表示被唤醒的任务应该抢占当前任务
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWakeFirstWaiter(CondVar_t *pxCondVar)
+{
+    ListItem_t *pxItem = pxCondVar->xTasksWaiting.xListEnd.pxNext;
+
+    pxItem->xItemValue = condvarSIGNALLED;
+
+    return xTaskRemoveItemFromEventList(pxItem);
+}
+
+/*---------------------------------------------------------------------------
+ *  唤醒一个等待任务
+ *---------------------------------------------------------------------------*/
+void vCondVarSignal(CondVarHandle_t xCondVar)
+{
+    CondVar_t *pxCondVar = (CondVar_t *)xCondVar;
+
+    taskENTER_CRITICAL();
+
+    if (pxCondVar->xTasksWaiting.uxNumberOfItems > 0)
+    {
+        if (prvWakeFirstWaiter(pxCondVar))
+        {
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+        }
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+/*---------------------------------------------------------------------------
+ *  唤醒全部等待任务
+ *
+ *  一个临界区里把等待链表上的任务全部放回就绪链表，最多触发一次 PendSV。
+ *  广播的一方通常还持有互斥量，被唤醒的任务会按优先级排到互斥量的等待链表上
+ *---------------------------------------------------------------------------*/
+void vCondVarBroadcast(CondVarHandle_t xCondVar)
+{
+    CondVar_t *pxCondVar = (CondVar_t *)xCondVar;
+    uint32_t xSwitchRequired = 0;
+
+    taskENTER_CRITICAL();
+
+    while (pxCondVar->xTasksWaiting.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= prvWakeFirstWaiter(pxCondVar);
+    }
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    taskEXIT_CRITICAL();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef CONDVAR_H
+#define CONDVAR_H
+
+#include <stdint.h>
+#include "mutex.h"
+
+/*---------------------------------------------------------------------------
+ *  条件变量结构
+ *
+ *  配合互斥量等待"被互斥量保护的共享状态满足某个条件"：
+ *  持锁检查条件，不满足就 xCondVarWait（原子地解锁 + 阻塞，醒来后重新加锁），
+ *  改变状态的一方持锁修改后 Signal/Broadcast
+ *---------------------------------------------------------------------------*/
+typedef struct CondVar
+{
+    List_t xTasksWaiting; /* 等待条件的任务，按优先级排序 */
+} CondVar_t;
+
+typedef CondVar_t *CondVarHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建条件变量
+ *   返回 : 句柄，失败返回 NULL
+ */
+CondVarHandle_t xCondVarCreate(void);
+
+/*
+ * 删除条件变量，调用前不能再有任务等在上面
+ */
+void vCondVarDelete(CondVarHandle_t xCondVar);
+
+/*
+ * 等待条件
+ *   xMutex       : 保护共享状态的互斥量，调用前必须由当前任务持有
+ *   xTicksToWait : 最多等多少 tick
+ *   返回         : 0 被唤醒，-1 超时或者没有持有互斥量
+ *
+ * 除了没有持有互斥量的情况，返回时都已重新持有互斥量（重新加锁走 xMutexTake，保留优先级继承）。
+ * 被唤醒不代表条件一定成立（别的任务可能先拿到锁改了状态），要在循环里重新检查：
+ *
+ *     xMutexTake(xMutex, portMAX_DELAY);
+ *     while (!条件)
+ *         xCondVarWait(xCond, xMutex, portMAX_DELAY);
+ *     ... 使用共享状态 ...
+ *     xMutexGive(xMutex);
+ */
+int32_t xCondVarWait(CondVarHandle_t xCondVar, MutexHandle_t xMutex, uint32_t xTicksToWait);
+
+/*
+ * 唤醒一个（优先级最高的）等待任务 / 唤醒全部等待任务
+ */
+void vCondVarSignal(CondVarHandle_t xCondVar);
+void vCondVarBroadcast(CondVarHandle_t xCondVar);
+
+#endif
\ No newline at end of file
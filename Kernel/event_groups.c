@@ -0,0 +1,246 @@
+#include "event_groups.h"
+#include "heap.h"
+
+/*---------------------------------------------------------------------------
+ *  判断事件位是否满足等待条件（内部函数）
+ *---------------------------------------------------------------------------*/
+static uint32_t prvTestWaitCondition(uint32_t uxCurrentEventBits,
+                                     uint32_t uxBitsToWaitFor,
+                                     uint32_t xWaitForAllBits)
+{
+    if (xWaitForAllBits == 0)
+    {
+        /* 任意一位置上就行 */
+        return (uxCurrentEventBits & uxBitsToWaitFor) != 0;
+    }
+
+    /* 所有位都要置上 */
+    return (uxCurrentEventBits & uxBitsToWaitFor) == uxBitsToWaitFor;
+}
+
+/*---------------------------------------------------------------------------
+ *  创建事件组
+ *---------------------------------------------------------------------------*/
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroup_t *pxEventGroup;
+
+    pxEventGroup = (EventGroup_t *)pvPortMalloc(sizeof(EventGroup_t));
+    if (pxEventGroup == NULL)
+        return NULL;
+
+    pxEventGroup->uxEventBits = 0;
+    vListInit(&(pxEventGroup->xTasksWaitingForBits));
+
+    return pxEventGroup;
+}
+
+/*---------------------------------------------------------------------------
+ *  等待事件位（带阻塞）
+ *---------------------------------------------------------------------------*/
+uint32_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup,
+                             uint32_t uxBitsToWaitFor,
+                             uint32_t xClearOnExit,
+                             uint32_t xWaitForAllBits,
+                             uint32_t xTicksToWait)
+{
+    EventGroup_t *pxEventGroup = (EventGroup_t *)xEventGroup;
+    uint32_t uxReturn;
+
+    /* 只能等用户位 */
+    uxBitsToWaitFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+    taskENTER_CRITICAL();
+
+    uxReturn = pxEventGroup->uxEventBits;
+
+    /* 条件已经满足，不用阻塞 */
+    if (prvTestWaitCondition(uxReturn, uxBitsToWaitFor, xWaitForAllBits))
+    {
+        if (xClearOnExit != 0)
+        {
+            pxEventGroup->uxEventBits &= ~uxBitsToWaitFor;
+        }
+
+        taskEXIT_CRITICAL();
+        return uxReturn;
+    }
+
+    /* 不等待，直接返回当前值 */
+    if (xTicksToWait == 0)
+    {
+        taskEXIT_CRITICAL();
+        return uxReturn;
+    }
+
+    /* 把等待条件记在 TCB 上，置位时按它判断 */
+    pxCurrentTCB->ulEventWaitBits = uxBitsToWaitFor;
+    if (xClearOnExit != 0)
+    {
+        pxCurrentTCB->ulEventWaitBits |= eventCLEAR_EVENTS_ON_EXIT_BIT;
+    }
+    if (xWaitForAllBits != 0)
+    {
+        pxCurrentTCB->ulEventWaitBits |= eventWAIT_FOR_ALL_BITS;
+    }
+
+    /* 阻塞：按优先级加入事件组等待链表，加入延时链表（超时），死等只在等待链表里 */
+    vTaskPlaceOnEventList(&(pxEventGroup->xTasksWaitingForBits), xTicksToWait);
+
+    taskEXIT_CRITICAL();
+
+    /* 触发切换，被置位或超时唤醒后从这里继续 */
+    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+    taskENTER_CRITICAL();
+
+    if ((pxCurrentTCB->ulEventWaitBits & eventUNBLOCKED_DUE_TO_BIT_SET) != 0)
+    {
+        /* 被置位唤醒：置位的人已经按需清过位了，返回唤醒那一刻的值 */
+        uxReturn = pxCurrentTCB->ulEventWaitBits & ~eventEVENT_BITS_CONTROL_BYTES;
+    }
+    else
+    {
+        /* 超时：返回当前值，刚好在超时那一刻满足了也按等到处理 */
+        uxReturn = pxEventGroup->uxEventBits;
+
+        if (xClearOnExit != 0 &&
+            prvTestWaitCondition(uxReturn, uxBitsToWaitFor, xWaitForAllBits))
+        {
+            pxEventGroup->uxEventBits &= ~uxBitsToWaitFor;
+        }
+    }
+
+    pxCurrentTCB->ulEventWaitBits = 0;
+
+    taskEXIT_CRITICAL();
+
+    return uxReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  置位并唤醒所有满足条件的任务（内部函数，必须在临界区内调用）
+ *
+ *  一次遍历等待链表：条件满足的任务全部放回就绪链表，
+ *  要求退出时清位的，先把位攒起来，遍历完再统一清，
+ *  保证同一次置位能唤醒所有等这些位的任务。
+ *  返回 1 表示有被唤醒的任务应该抢占当前任务
+ *---------------------------------------------------------------------------*/
+static uint32_t prvSetBitsAndWake(EventGroup_t *pxEventGroup, uint32_t uxBitsToSet)
+{
+    List_t *pxList = &(pxEventGroup->xTasksWaitingForBits);
+    ListItem_t *pxItem;
+    ListItem_t *pxNext;
+    uint32_t uxBitsToClear = 0;
+    uint32_t xSwitchRequired = 0;
+
+    pxEventGroup->uxEventBits |= (uxBitsToSet & ~eventEVENT_BITS_CONTROL_BYTES);
+
+    pxItem = pxList->xListEnd.pxNext;
+    while ((void *)pxItem != (void *)&(pxList->xListEnd))
+    {
+        TCB_t *pxTCB = (TCB_t *)pxItem->pvOwner;
+        uint32_t uxControlBits = pxTCB->ulEventWaitBits & eventEVENT_BITS_CONTROL_BYTES;
+        uint32_t uxBitsWaitedFor = pxTCB->ulEventWaitBits & ~eventEVENT_BITS_CONTROL_BYTES;
+
+        /* 唤醒后节点会被移走，先记住下一个 */
+        pxNext = pxItem->pxNext;
+
+        if (prvTestWaitCondition(pxEventGroup->uxEventBits, uxBitsWaitedFor,
+                                 uxControlBits & eventWAIT_FOR_ALL_BITS))
+        {
+            if ((uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT) != 0)
+            {
+                uxBitsToClear |= uxBitsWaitedFor;
+            }
+
+            /* 把唤醒那一刻的事件位交给等待的任务 */
+            pxTCB->ulEventWaitBits = pxEventGroup->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET;
+
+            if (xTaskRemoveItemFromEventList(pxItem))
+            {
+                xSwitchRequired = 1;
+            }
+        }
+
+        pxItem = pxNext;
+    }
+
+    pxEventGroup->uxEventBits &= ~uxBitsToClear;
+
+    return xSwitchRequired;
+}
+
+/*---------------------------------------------------------------------------
+ *  置位
+ *---------------------------------------------------------------------------*/
+uint32_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, uint32_t uxBitsToSet)
+{
+    EventGroup_t *pxEventGroup = (EventGroup_t *)xEventGroup;
+    uint32_t uxReturn;
+
+    taskENTER_CRITICAL();
+
+    /* 唤醒多少个任务都只触发一次 PendSV */
+    if (prvSetBitsAndWake(pxEventGroup, uxBitsToSet))
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    uxReturn = pxEventGroup->uxEventBits;
+
+    taskEXIT_CRITICAL();
+
+    return uxReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中置位（不阻塞）
+ *---------------------------------------------------------------------------*/
+uint32_t xEventGroupSetBitsFromISR(EventGroupHandle_t xEventGroup, uint32_t uxBitsToSet,
+                                   uint32_t *pxHigherPriorityTaskWoken)
+{
+    EventGroup_t *pxEventGroup = (EventGroup_t *)xEventGroup;
+    uint32_t ulSavedInterruptStatus;
+    uint32_t uxReturn;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    if (prvSetBitsAndWake(pxEventGroup, uxBitsToSet) &&
+        pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = 1;
+    }
+
+    uxReturn = pxEventGroup->uxEventBits;
+
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    return uxReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  清位
+ *---------------------------------------------------------------------------*/
+uint32_t xEventGroupClearBits(EventGroupHandle_t xEventGroup, uint32_t uxBitsToClear)
+{
+    EventGroup_t *pxEventGroup = (EventGroup_t *)xEventGroup;
+    uint32_t uxReturn;
+
+    taskENTER_CRITICAL();
+
+    uxReturn = pxEventGroup->uxEventBits;
+    pxEventGroup->uxEventBits &= ~(uxBitsToClear & ~eventEVENT_BITS_CONTROL_BYTES);
+
+    taskEXIT_CRITICAL();
+
+    return uxReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  读取当前事件位
+ *---------------------------------------------------------------------------*/
+uint32_t xEventGroupGetBits(EventGroupHandle_t xEventGroup)
+{
+    return ((EventGroup_t *)xEventGroup)->uxEventBits;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef EVENT_GROUPS_H
+#define EVENT_GROUPS_H
+
+#include <stdint.h>
+#include "list.h"
+#include "task.h"
+#include "queue.h"
+
+/*---------------------------------------------------------------------------
+ *  事件位
+ *
+ *  低 24 位给用户当事件位用，高 8 位是内核控制位，
+ *  阻塞时和等待的位一起存在等待任务的 TCB->ulEventWaitBits 里
+ *---------------------------------------------------------------------------*/
+#define eventCLEAR_EVENTS_ON_EXIT_BIT 0x01000000UL /* 等到后清掉等待的位 */
+#define eventUNBLOCKED_DUE_TO_BIT_SET 0x02000000UL /* 被置位唤醒（不是超时） */
+#define eventWAIT_FOR_ALL_BITS 0x04000000UL        /* 所有位都置上才算等到 */
+#define eventEVENT_BITS_CONTROL_BYTES 0xFF000000UL /* 控制位掩码 */
+
+/*---------------------------------------------------------------------------
+ *  事件组结构
+ *---------------------------------------------------------------------------*/
+typedef struct EventGroupDefinition
+{
+    uint32_t uxEventBits;        /* 当前事件位（只用低 24 位） */
+    List_t xTasksWaitingForBits; /* 等待事件位的任务链表 */
+} EventGroup_t;
+
+typedef EventGroup_t *EventGroupHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建事件组（从堆上分配），所有位初始为 0
+ *   返回 : 事件组句柄，失败返回 NULL
+ */
+EventGroupHandle_t xEventGroupCreate(void);
+
+/*
+ * 等待事件位
+ *   uxBitsToWaitFor : 要等的位（不能为 0，不能含高 8 位）
+ *   xClearOnExit    : 非 0 时等到后把 uxBitsToWaitFor 清掉
+ *   xWaitForAllBits : 非 0 等所有位（与），0 等任意一位（或）
+ *   xTicksToWait    : 最多等多少 tick（0 = 不等，portMAX_DELAY = 死等）
+ *   返回            : 等到那一刻的事件位（清除前的值）；
+ *                     超时返回当前事件位，调用者自己判断条件是否满足
+ */
+uint32_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup,
+                             uint32_t uxBitsToWaitFor,
+                             uint32_t xClearOnExit,
+                             uint32_t xWaitForAllBits,
+                             uint32_t xTicksToWait);
+
+/*
+ * 置位，一次遍历唤醒所有条件满足的任务，最多触发一次切换
+ *   返回 : 置位并处理完等待任务后的事件位
+ */
+uint32_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, uint32_t uxBitsToSet);
+
+/*
+ * 在中断中置位（不阻塞），用法同 xQueueSendFromISR
+ */
+uint32_t xEventGroupSetBitsFromISR(EventGroupHandle_t xEventGroup, uint32_t uxBitsToSet,
+                                   uint32_t *pxHigherPriorityTaskWoken);
+
+/*
+ * 清位
+ *   返回 : 清除前的事件位
+ */
+uint32_t xEventGroupClearBits(EventGroupHandle_t xEventGroup, uint32_t uxBitsToClear);
+
+/*
+ * 读取当前事件位
+ */
+uint32_t xEventGroupGetBits(EventGroupHandle_t xEventGroup);
+
+#endif
\ No newline at end of file
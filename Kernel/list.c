@@ -63,7 +63,7 @@ void vListInsertEnd(List_t *pxList, ListItem_t *pxNewItem)
 /*---------------------------------------------------------------------------
  *  按 xItemValue 排序插入（升序）
  *
- *  用途：延时链表中，唤醒时间早的排前面
+ *  用途：事件等待链表中，优先级高的排前面（值相等的先到先服务）
  *
  *  遍历链表找到第一个 value 比 newItem 大的节点，插在它前面
  *  哨兵 value = MAX，所以新节点一定插在哨兵前面
@@ -100,6 +100,39 @@ void vListInsert(List_t *pxList, ListItem_t *pxNewItem)
     pxList->uxNumberOfItems++;
 }
 
+/*---------------------------------------------------------------------------
+ *  按 xItemValue 环形排序插入（升序，值会溢出回绕）
+ *
+ *  用途：EDF 就绪链表中，截止时间早的排前面
+ *
+ *  截止时间是 tick 值，会从 0xFFFFFFFF 绕回 0，不能直接比大小，
+ *  用有符号差值比较：(int32_t)(a - b) > 0 表示 a 在 b 之后。
+ *  相等的值插在已有节点后面（先到先服务）
+ *---------------------------------------------------------------------------*/
+void vListInsertWrapped(List_t *pxList, ListItem_t *pxNewItem)
+{
+    ListItem_t *pxIterator;
+    const uint32_t xValueToInsert = pxNewItem->xItemValue;
+
+    for (pxIterator = (ListItem_t *)&(pxList->xListEnd);
+         (pxIterator->pxNext != (ListItem_t *)&(pxList->xListEnd)) &&
+         ((int32_t)(pxIterator->pxNext->xItemValue - xValueToInsert) <= 0);
+         pxIterator = pxIterator->pxNext)
+    {
+        /* 空循环体，找到插入位置 */
+    }
+
+    /* 插在 pxIterator 后面 */
+    pxNewItem->pxNext = pxIterator->pxNext;
+    pxNewItem->pxPrevious = pxIterator;
+    pxIterator->pxNext->pxPrevious = pxNewItem;
+    pxIterator->pxNext = pxNewItem;
+
+    pxNewItem->pvContainer = pxList;
+
+    pxList->uxNumberOfItems++;
+}
+
 /*---------------------------------------------------------------------------
  *  移除节点
  *
@@ -113,10 +146,13 @@ uint32_t uxListRemove(ListItem_t *pxItemToRemove)
     pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
     pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
 
-    /* 如果游标正好指向被删的节点，退回到前一个 */
+    /*
+     * 如果游标正好指向被删的节点，移到后一个
+     * 就绪链表中游标指向正在占用时间片的任务，它离开后轮到它后面的任务
+     */
     if (pxList->pxIndex == pxItemToRemove)
     {
-        pxList->pxIndex = pxItemToRemove->pxPrevious;
+        pxList->pxIndex = pxItemToRemove->pxNext;
     }
 
     /* 标记：不再属于任何链表 */
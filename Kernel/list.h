@@ -45,6 +45,7 @@ void vListInit(List_t *pxList);
 void vListInitItem(ListItem_t *pxItem);
 void vListInsertEnd(List_t *pxList, ListItem_t *pxNewItem);
 void vListInsert(List_t *pxList, ListItem_t *pxNewItem);
+void vListInsertWrapped(List_t *pxList, ListItem_t *pxNewItem);
 uint32_t uxListRemove(ListItem_t *pxItemToRemove);
 
 #endif
\ No newline at end of file
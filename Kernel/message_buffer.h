@@ -0,0 +1,59 @@
+#ifndef MESSAGE_BUFFER_H
+#define MESSAGE_BUFFER_H
+
+#include "stream_buffer.h"
+
+/*---------------------------------------------------------------------------
+ *  消息缓冲区句柄（本质就是流缓冲区句柄）
+ *
+ *  变长消息存在同一个字节环形缓冲区里，每条消息前面有 2 字节长度头，
+ *  一条消息只占 长度 + 2 字节，不用像队列那样按最大长度留空间。
+ *  整条收发：要么整条写进去/读出来，要么什么都不做。
+ *  和流缓冲区一样只允许一个写者和一个读者
+ *---------------------------------------------------------------------------*/
+typedef StreamBufferHandle_t MessageBufferHandle_t;
+
+/*
+ * 创建消息缓冲区
+ *   xBufferSizeBytes : 缓冲区总字节数（每条消息额外占 sbBYTES_TO_STORE_MESSAGE_LENGTH 字节）
+ *   返回             : 句柄，失败返回 NULL
+ */
+#define xMessageBufferCreate(xBufferSizeBytes) \
+    xStreamBufferGenericCreate((xBufferSizeBytes), 0, 1)
+
+/* 删除消息缓冲区，阻塞的读写任务醒来返回 0，规则同 vStreamBufferDelete */
+#define vMessageBufferDelete(xMessageBuffer) \
+    vStreamBufferDelete((xMessageBuffer))
+
+/*
+ * 发送一条消息
+ *   xTicksToWait : 空间不够放下整条消息时最多等多少 tick
+ *   返回         : 成功返回 xDataLengthBytes，超时或消息比缓冲区还大返回 0
+ */
+#define xMessageBufferSend(xMessageBuffer, pvTxData, xDataLengthBytes, xTicksToWait) \
+    xStreamBufferSend((xMessageBuffer), (pvTxData), (xDataLengthBytes), (xTicksToWait))
+
+#define xMessageBufferSendFromISR(xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken) \
+    xStreamBufferSendFromISR((xMessageBuffer), (pvTxData), (xDataLengthBytes), (pxHigherPriorityTaskWoken))
+
+/*
+ * 接收一条消息
+ *   xBufferLengthBytes : 接收缓冲区大小，放不下下一条消息时返回 0，消息留在缓冲区里
+ *   xTicksToWait       : 没有消息时最多等多少 tick
+ *   返回               : 消息的字节数，超时返回 0
+ */
+#define xMessageBufferReceive(xMessageBuffer, pvRxData, xBufferLengthBytes, xTicksToWait) \
+    xStreamBufferReceive((xMessageBuffer), (pvRxData), (xBufferLengthBytes), (xTicksToWait))
+
+#define xMessageBufferReceiveFromISR(xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken) \
+    xStreamBufferReceiveFromISR((xMessageBuffer), (pvRxData), (xBufferLengthBytes), (pxHigherPriorityTaskWoken))
+
+/* 下一条消息的长度（用来准备接收缓冲区），没有消息返回 0 */
+#define xMessageBufferNextLengthBytes(xMessageBuffer) \
+    xStreamBufferNextMessageLengthBytes((xMessageBuffer))
+
+/* 剩余空间（字节，发送 n 字节的消息需要 n + sbBYTES_TO_STORE_MESSAGE_LENGTH） */
+#define xMessageBufferSpacesAvailable(xMessageBuffer) \
+    xStreamBufferSpacesAvailable((xMessageBuffer))
+
+#endif
\ No newline at end of file
@@ -1,27 +1,18 @@
 #include "mutex.h"
+#include "heap.h"
 #include <string.h>
 
 /*---------------------------------------------------------------------------
- *  静态分配
- *---------------------------------------------------------------------------*/
-#define MAX_MUTEXES 4
-
-static Mutex_t xMutexPool[MAX_MUTEXES]; /*静态分配数组池*/
-static uint32_t uxMutexCount = 0;       /*当前分配了0个*/
-
-/*---------------------------------------------------------------------------
- *  创建互斥量
+ *  创建互斥量（从堆上分配）
  *---------------------------------------------------------------------------*/
 MutexHandle_t xMutexCreate(void)
 {
     Mutex_t *pxNewMutex;
 
-    if (uxMutexCount >= MAX_MUTEXES) /*超过分配池数量了*/
+    pxNewMutex = (Mutex_t *)pvPortMalloc(sizeof(Mutex_t)); /*拿到互斥锁指针*/
+    if (pxNewMutex == NULL)
         return NULL;
 
-    pxNewMutex = &xMutexPool[uxMutexCount]; /*拿到互斥锁指针*/
-    uxMutexCount++;                         /*数量增加*/
-
     /* 初始化底层队列：容量1，大小0 */
     pxNewMutex->xQueue.pcHead = NULL;
     pxNewMutex->xQueue.pcTail = NULL;
@@ -30,6 +21,12 @@ MutexHandle_t xMutexCreate(void)
     pxNewMutex->xQueue.uxLength = 1;          /*容量1*/
     pxNewMutex->xQueue.uxItemSize = 0;        /*大小0*/
     pxNewMutex->xQueue.uxMessagesWaiting = 1; /* 初始可用（和信号量不同！） */
+    pxNewMutex->xQueue.uxWriteLoan = 0;
+    pxNewMutex->xQueue.uxReadLoan = 0;
+    pxNewMutex->xQueue.uxWaitingTasks = 0;
+    pxNewMutex->xQueue.uxDeleted = 0;
+    pxNewMutex->xQueue.pxQueueSetContainer = NULL;
+    pxNewMutex->xQueue.uxSetMembers = 0;
 
     /*初始化两个等待链表*/
     vListInit(&(pxNewMutex->xQueue.xTasksWaitingToSend));
@@ -51,6 +48,8 @@ MutexHandle_t xMutexCreate(void)
 int32_t xMutexTake(MutexHandle_t xMutex, uint32_t xTicksToWait)
 {
     Mutex_t *pxMutex = (Mutex_t *)xMutex; /*拿到互斥锁地址*/
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
 
     for (;;)
     {
@@ -85,28 +84,30 @@ int32_t xMutexTake(MutexHandle_t xMutex, uint32_t xTicksToWait)
                 vTaskPrioritySet(pxMutex->pxOwner, pxCurrentTCB->uxPriority);
             }
 
-            /* 从就绪链表移除自己 */
-            prvRemoveTaskFromReadyList(pxCurrentTCB);
-
-            /* 加入互斥量等待链表 */
-            vListInsertEnd(&(pxMutex->xQueue.xTasksWaitingToReceive),
-                           &(pxCurrentTCB->xEventListItem));
-
-            /* 加入延时链表（超时），最大阻塞不用加入阻塞队列，只在等待队列里面 */
-            if (xTicksToWait < portMAX_DELAY)
+            /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+            if (xEntryTimeSet == 0)
             {
-                prvAddCurrentTaskToDelayedList(xTicksToWait);
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = 1;
             }
 
+            /* 从就绪链表移除自己，按优先级加入互斥量等待链表，
+               加入延时链表（超时），最大阻塞不用加入阻塞队列，只在等待队列里面 */
+            prvQueueWaitOnList(&(pxMutex->xQueue), &(pxMutex->xQueue.xTasksWaitingToReceive), xTicksToWait);
+
             taskEXIT_CRITICAL();
 
             /* 触发切换 */
             portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
 
-            if (xTicksToWait != portMAX_DELAY) /*如果等待时间不是max，清零等待时间，下一次直接返回*/
+            /* 被唤醒后撤销等待登记，等待期间互斥量被删除就直接失败 */
+            if (prvQueueWaitFinished(&(pxMutex->xQueue)))
             {
-                xTicksToWait = 0;
+                return -1;
             }
+
+            /* 锁可能被更高优先级的任务先拿走了：没到超时就按剩余时间继续等（死等不变） */
+            (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
         }
     }
 }
@@ -145,25 +146,8 @@ int32_t xMutexGive(MutexHandle_t xMutex)
     /* 唤醒等待的任务（让它回到 for 循环自己去拿锁） */
     if (pxMutex->xQueue.xTasksWaitingToReceive.uxNumberOfItems > 0)
     {
-        /*拿到等待队列中的第一个列表项*/
-        ListItem_t *pxItem = pxMutex->xQueue.xTasksWaitingToReceive.xListEnd.pxNext;
-        /*拿到他的tcb*/
-        TCB_t *pxTCB = (TCB_t *)pxItem->pvOwner;
-
-        /*将第一个列表项从列表中移除*/
-        uxListRemove(pxItem);
-
-        if (pxTCB->xStateListItem.pvContainer != NULL)
-        {
-            /*把任务管理列表项从对应列表上移除*/
-            uxListRemove(&(pxTCB->xStateListItem));
-        }
-
-        /*加入就绪队列（唤醒）*/
-        prvAddTaskToReadyList(pxTCB);
-
-        /*如果优先级大于当前正在运行任务优先级，直接切换*/
-        if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+        /*如果比当前正在运行任务更该运行，直接切换*/
+        if (xTaskRemoveFromEventList(&(pxMutex->xQueue.xTasksWaitingToReceive)))
         {
             portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
         }
@@ -171,4 +155,28 @@ int32_t xMutexGive(MutexHandle_t xMutex)
 
     taskEXIT_CRITICAL();
     return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  删除互斥量
+ *
+ *  持有者被继承的优先级恢复原值，等待的任务全部放出来，它们的 Take 返回失败
+ *  （Mutex_t 第一个成员就是 Queue_t，内存由 vQueueDelete 统一释放）
+ *---------------------------------------------------------------------------*/
+void vMutexDelete(MutexHandle_t xMutex)
+{
+    Mutex_t *pxMutex = (Mutex_t *)xMutex;
+
+    taskENTER_CRITICAL();
+
+    if (pxMutex->pxOwner != NULL &&
+        pxMutex->pxOwner->uxPriority != pxMutex->uxOriginalPriority)
+    {
+        vTaskPrioritySet(pxMutex->pxOwner, pxMutex->uxOriginalPriority);
+    }
+    pxMutex->pxOwner = NULL;
+
+    taskEXIT_CRITICAL();
+
+    vQueueDelete(&(pxMutex->xQueue));
 }
\ No newline at end of file
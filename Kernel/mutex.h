@@ -22,5 +22,6 @@ typedef Mutex_t *MutexHandle_t;
 MutexHandle_t xMutexCreate(void);
 int32_t xMutexTake(MutexHandle_t xMutex, uint32_t xTicksToWait);
 int32_t xMutexGive(MutexHandle_t xMutex);
+void vMutexDelete(MutexHandle_t xMutex);
 
 #endif
\ No newline at end of file
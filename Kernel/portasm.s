@@ -1,7 +1,7 @@
 ;===========================================================
 ; 文件说明：FreeRTOS 在 ARM Cortex-M 上的任务调度汇编实现
 ; 汇编器：ARM armasm（Keil MDK 风格）
-; 架构：  ARM Cortex-M3/M4/M7（Thumb-2 指令集）
+; 架构：  ARM Cortex-M4F（Thumb-2 指令集 + FPv4-SP 单精度浮点）
 ; 作用：  实现任务的首次启动和上下文切换
 ;===========================================================
 
@@ -18,6 +18,7 @@
     ; 导入外部符号（C 代码中定义）
     IMPORT pxCurrentTCB             ; 指向当前任务控制块（TCB）的指针
     IMPORT vTaskSwitchContext       ; FreeRTOS 的任务切换函数（选择下一个任务）
+    IMPORT ulMaxSyscallInterruptPriority ; 临界区 BASEPRI 屏蔽值（task.h 中配置）
 
 
 ;===========================================================
@@ -34,6 +35,10 @@ vPortStartFirstTask PROC
     LDR     r0, [r0]                ; r0 = 向量表[0]，即初始 MSP 栈顶值
     MSR     msp, r0                 ; 将 MSP 恢复为初始值（丢弃启动阶段的栈数据）
 
+    ; --- 清除 CONTROL.FPCA，启动阶段用过的 FPU 上下文不带进任务 ---
+    MOV     r0, #0
+    MSR     control, r0
+
     ; --- 第二步：使能中断 ---
     CPSIE   i                       ; 使能全局中断（清除 PRIMASK）
     CPSIE   f                       ; 使能全局异常/故障中断（清除 FAULTMASK）
@@ -62,12 +67,12 @@ SVC_Handler PROC
     LDR     r1, [r3]                ; r1 = pxCurrentTCB（当前 TCB 的地址）
     LDR     r0, [r1]                ; r0 = pxCurrentTCB->pxTopOfStack（任务栈顶）
 
-    ; --- 第二步：从任务栈中恢复 r4-r11（手动保存的寄存器）---
+    ; --- 第二步：从任务栈中恢复 r4-r11 和 EXC_RETURN（手动保存的寄存器）---
     ; 创建任务时，FreeRTOS 会在栈中预先压入初始寄存器值
     ; 栈中数据布局（从低地址到高地址）：
-    ;   [r4, r5, r6, r7, r8, r9, r10, r11]  ← 手动保存的
-    ;   [r0, r1, r2, r3, r12, LR, PC, xPSR] ← 硬件自动恢复的
-    LDMIA   r0!, {r4-r11}           ; 从栈中弹出 r4-r11，从 r0 指向的地址连续读取 8 个字（32 字节）
+    ;   [r4, r5, r6, r7, r8, r9, r10, r11, EXC_RETURN]  ← 手动保存的
+    ;   [r0, r1, r2, r3, r12, LR, PC, xPSR]             ← 硬件自动恢复的
+    LDMIA   r0!, {r4-r11, r14}      ; 从栈中弹出 r4-r11 和 r14，连续读取 9 个字（36 字节）
     MSR     psp, r0                 ; 将更新后的 r0 设为 PSP（进程栈指针）
                                     ; 此时 PSP 指向硬件自动恢复的部分，指向 [r0, r1, r2, r3, r12, LR, PC, xPSR] 的起始位置
     ISB                             ; 指令同步屏障
@@ -77,13 +82,11 @@ SVC_Handler PROC
     MSR     basepri, r0             ; BASEPRI = 0，不屏蔽任何中断
 
     ; --- 第四步：返回任务（切换到线程模式 + 使用 PSP）---
-    ; LR（r14）的特殊值 EXC_RETURN：
-    ;   0xFFFFFFFD = 返回线程模式，使用 PSP
-    ; ORR 0x0D 确保：
-    ;   bit[0] = 1 → Thumb 模式
+    ; r14 已经从任务栈中取出，是 prvInitialiseStack 写入的 EXC_RETURN：
+    ;   0xFFFFFFFD = 返回线程模式，使用 PSP，不带 FPU 的短帧
     ;   bit[2] = 1 → 返回时使用 PSP（而非 MSP）
     ;   bit[3] = 1 → 返回线程模式
-    ORR     r14, r14, #0x0D         ; 设置 EXC_RETURN = 0xFFFFFFFD
+    ;   bit[4] = 1 → 栈帧里没有 FPU 寄存器
     BX      r14                     ; 异常返回：
                                     ;   硬件自动从 PSP 恢复 r0-r3,r12,LR,PC,xPSR
                                     ;   CPU 跳转到任务函数开始执行
@@ -95,11 +98,52 @@ SVC_Handler PROC
 ; 作用：执行任务上下文切换（保存当前任务 + 恢复下一个任务）
 ; 触发时机：FreeRTOS 在 SysTick 或 yield 时挂起 PendSV
 ; 注意：PendSV 优先级设为最低，确保不会打断其他中断
+;       先选下一个任务，选出来还是当前任务就直接返回，不保存/恢复 r4-r11
+;
+; FPU 懒压栈（FPCCR.ASPEN = LSPEN = 1）：
+;   任务用过 FPU 时 CONTROL.FPCA = 1，异常入口 EXC_RETURN bit4 = 0，
+;   硬件为 s0-s15/FPSCR 预留空间，真正执行浮点指令时才写入。
+;   软件只在 bit4 = 0 时额外保存 s16-s31，没用过 FPU 的任务保持短帧：
+;     短帧   ：硬件  8 字 + 软件  9 字（r4-r11, EXC_RETURN）
+;     FPU 帧 ：硬件 26 字 + 软件 25 字（再加 s16-s31）
 ;===========================================================
 PendSV_Handler PROC
 
     ;=======================================================
-    ;  第一部分：保存当前任务的上下文
+    ;  第一部分：调用 vTaskSwitchContext 选择下一个任务
+    ;=======================================================
+
+    ; vTaskSwitchContext 是 C 函数，按 AAPCS 会保护 r4-r11，
+    ; 所以可以先调用它，r4-r11 里仍然是当前任务的值
+    LDR     r3, =pxCurrentTCB       ; r3 = &pxCurrentTCB
+    LDR     r2, [r3]                ; r2 = 切换前的 TCB
+    PUSH    {r2, r14}               ; 保护旧 TCB 和 r14（EXC_RETURN），两个寄存器保持 8 字节对齐
+
+    ; 选任务期间用 BASEPRI 屏蔽能调用内核 API 的中断（和临界区一样），
+    ; 更高优先级的中断照常响应
+    LDR     r0, =ulMaxSyscallInterruptPriority
+    LDR     r0, [r0]
+    MSR     basepri, r0
+    DSB
+    ISB
+    BL      vTaskSwitchContext      ; 调用 C 函数：
+                                    ;   - 检查就绪任务列表
+                                    ;   - 选择最高优先级任务
+                                    ;   - 更新 pxCurrentTCB 指向新任务
+    MOV     r0, #0
+    MSR     basepri, r0             ; 恢复 BASEPRI = 0
+    POP     {r2, r14}               ; 恢复旧 TCB 和 r14
+
+    LDR     r3, =pxCurrentTCB       ; r3 = &pxCurrentTCB
+    LDR     r1, [r3]                ; r1 = 切换后的 TCB
+
+    ; --- 选出来的还是当前任务：不用切换，直接返回 ---
+    CMP     r1, r2
+    IT      EQ
+    BXEQ    r14                     ; 硬件自动出栈，回到原任务继续运行
+
+    ;=======================================================
+    ;  第二部分：保存当前任务的上下文
     ;=======================================================
 
     ; --- 获取当前任务的 PSP ---
@@ -107,42 +151,36 @@ PendSV_Handler PROC
     MRS     r0, psp                 ; r0 = 当前任务的 PSP（硬件压栈后的位置）
     ISB                             ; 指令同步屏障
 
-    ; --- 获取当前 TCB ---
-    LDR     r3, =pxCurrentTCB       ; r3 = &pxCurrentTCB
-    LDR     r2, [r3]                ; r2 = pxCurrentTCB（当前任务 TCB 地址）
+    ; --- 任务用过 FPU（EXC_RETURN bit4 = 0），保存 s16-s31 ---
+    ; 这条浮点指令同时会触发硬件把懒压栈预留的 s0-s15/FPSCR 写入
+    TST     r14, #0x10
+    IT      EQ
+    VSTMDBEQ r0!, {s16-s31}
 
-    ; --- 手动保存 r4-r11 到当前任务栈 ---
+    ; --- 手动保存 r4-r11 和 EXC_RETURN 到当前任务栈 ---
     ; STMDB: Store Multiple, Decrement Before（先减后存，满递减栈）
     ; 硬件只自动保存 r0-r3,r12,LR,PC,xPSR
-    ; r4-r11 需要我们手动保存
-    STMDB   r0!, {r4-r11}           ; 将 r4-r11 压入任务栈，r0 自动递减
+    ; r4-r11 需要我们手动保存，EXC_RETURN 记录这个任务的栈帧类型
+    STMDB   r0!, {r4-r11, r14}      ; 将 r4-r11、r14 压入任务栈，r0 自动递减
 
     ; --- 更新 TCB 中的栈顶指针 ---
-    STR     r0, [r2]                ; pxCurrentTCB->pxTopOfStack = r0
+    STR     r0, [r2]                ; 旧 TCB->pxTopOfStack = r0
                                     ; 保存更新后的栈顶位置
 
-    ;=======================================================
-    ;  第二部分：调用 FreeRTOS 选择下一个任务
-    ;=======================================================
-
-    ; 保存 r3（&pxCurrentTCB）和 r14（EXC_RETURN），因为调用 C 函数会破坏它们
-    PUSH    {r3, r14}               ; 保护关键寄存器
-    BL      vTaskSwitchContext      ; 调用 C 函数：
-                                    ;   - 检查就绪任务列表
-                                    ;   - 选择最高优先级任务
-                                    ;   - 更新 pxCurrentTCB 指向新任务
-    POP     {r3, r14}               ; 恢复 r3 和 r14
-
     ;=======================================================
     ;  第三部分：恢复新任务的上下文
     ;=======================================================
 
     ; --- 获取新任务的栈顶指针 ---
-    LDR     r1, [r3]                ; r1 = pxCurrentTCB（已被 vTaskSwitchContext 更新为新任务）
     LDR     r0, [r1]                ; r0 = 新任务的 pxTopOfStack
 
-    ; --- 从新任务栈中恢复 r4-r11 ---
-    LDMIA   r0!, {r4-r11}           ; 弹出 r4-r11，r0 自动递增
+    ; --- 从新任务栈中恢复 r4-r11 和它的 EXC_RETURN ---
+    LDMIA   r0!, {r4-r11, r14}      ; 弹出 r4-r11、r14，r0 自动递增
+
+    ; --- 新任务用过 FPU，恢复 s16-s31 ---
+    TST     r14, #0x10
+    IT      EQ
+    VLDMIAEQ r0!, {s16-s31}
 
     ; --- 设置 PSP 为新任务的栈指针 ---
     MSR     psp, r0                 ; PSP 指向新任务栈中硬件自动恢复的部分
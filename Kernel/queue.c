@@ -1,42 +1,31 @@
 #include "queue.h"
 #include "task.h"
+#include "heap.h"
 #include <string.h>
 
-/*---------------------------------------------------------------------------
- *  静态分配（和 task.c 一样，先用静态数组）
- *---------------------------------------------------------------------------*/
-#define MAX_QUEUES 4
-#define QUEUE_POOL_SIZE 512 /* 所有队列共享的缓冲区（字节） */
-
-static Queue_t xQueuePool[MAX_QUEUES];
-static uint32_t uxQueueCount = 0;
-
-static int8_t ucQueueStoragePool[QUEUE_POOL_SIZE];
-static uint32_t uxStorageUsed = 0;
-
 /*---------------------------------------------------------------------------
  *  创建队列
+ *
+ *  控制块和缓冲区一次从堆上分配，缓冲区紧跟在 Queue_t 后面，
+ *  vQueueDelete 一次释放
  *---------------------------------------------------------------------------*/
 QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize)
 {
     Queue_t *pxNewQueue;
     uint32_t uxBufSize;
 
-    if (uxQueueCount >= MAX_QUEUES)
+    if (uxQueueLength == 0)
         return NULL;
 
     /* 计算需要的缓冲区大小 */
     uxBufSize = uxQueueLength * uxItemSize;
 
-    if ((uxStorageUsed + uxBufSize) > QUEUE_POOL_SIZE)
+    pxNewQueue = (Queue_t *)pvPortMalloc(sizeof(Queue_t) + uxBufSize);
+    if (pxNewQueue == NULL)
         return NULL;
 
-    pxNewQueue = &xQueuePool[uxQueueCount];
-    uxQueueCount++;
-
-    /* 分配缓冲区 */
-    pxNewQueue->pcHead = &ucQueueStoragePool[uxStorageUsed];
-    uxStorageUsed += uxBufSize;
+    /* 缓冲区在控制块后面 */
+    pxNewQueue->pcHead = (int8_t *)(pxNewQueue + 1);
     pxNewQueue->pcTail = pxNewQueue->pcHead + uxBufSize;
 
     /* 初始化读写指针 */
@@ -47,6 +36,12 @@ QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize)
     pxNewQueue->uxLength = uxQueueLength;
     pxNewQueue->uxItemSize = uxItemSize;
     pxNewQueue->uxMessagesWaiting = 0;
+    pxNewQueue->uxWriteLoan = 0;
+    pxNewQueue->uxReadLoan = 0;
+    pxNewQueue->uxWaitingTasks = 0;
+    pxNewQueue->uxDeleted = 0;
+    pxNewQueue->pxQueueSetContainer = NULL;
+    pxNewQueue->uxSetMembers = 0;
 
     /* 初始化等待链表 */
     vListInit(&(pxNewQueue->xTasksWaitingToSend));
@@ -55,29 +50,254 @@ QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize)
     return pxNewQueue;
 }
 
+/*---------------------------------------------------------------------------
+ *  判断已删除的队列能不能释放了（内部函数，必须在临界区内调用）
+ *
+ *  没有任务还在阻塞流程里，作为集合时也没有成员还指着它
+ *---------------------------------------------------------------------------*/
+static uint32_t prvQueueCanFree(Queue_t *pxQueue)
+{
+    return (pxQueue->uxDeleted != 0 &&
+            pxQueue->uxWaitingTasks == 0 &&
+            pxQueue->uxSetMembers == 0);
+}
+
+/*---------------------------------------------------------------------------
+ *  把成员从所属集合里摘掉（内部函数，必须在临界区内调用）
+ *
+ *  集合里属于这个成员的句柄都清掉，其余句柄保持原来的顺序；
+ *  返回 1 表示集合已被删除且这是最后一个成员，调用者退出临界区后释放集合
+ *---------------------------------------------------------------------------*/
+static uint32_t prvRemoveFromSetContainer(Queue_t *pxQueue)
+{
+    Queue_t *pxQueueSet = pxQueue->pxQueueSetContainer;
+    Queue_t *pxMember;
+    int8_t *pcRead;
+    int8_t *pcWrite;
+    uint32_t uxKept = 0;
+    uint32_t i;
+
+    /* 从下一个要读的位置开始，把不属于这个成员的句柄往前挪 */
+    pcRead = pxQueueSet->pcReadFrom + pxQueueSet->uxItemSize;
+    if (pcRead >= pxQueueSet->pcTail)
+    {
+        pcRead = pxQueueSet->pcHead;
+    }
+    pcWrite = pcRead;
+
+    for (i = 0; i < pxQueueSet->uxMessagesWaiting; i++)
+    {
+        memcpy(&pxMember, (void *)pcRead, sizeof(Queue_t *));
+
+        if (pxMember != pxQueue)
+        {
+            memcpy((void *)pcWrite, &pxMember, sizeof(Queue_t *));
+            uxKept++;
+
+            pcWrite += pxQueueSet->uxItemSize;
+            if (pcWrite >= pxQueueSet->pcTail)
+            {
+                pcWrite = pxQueueSet->pcHead;
+            }
+        }
+
+        pcRead += pxQueueSet->uxItemSize;
+        if (pcRead >= pxQueueSet->pcTail)
+        {
+            pcRead = pxQueueSet->pcHead;
+        }
+    }
+
+    pxQueueSet->pcWriteTo = pcWrite;
+    pxQueueSet->uxMessagesWaiting = uxKept;
+
+    pxQueue->pxQueueSetContainer = NULL;
+    pxQueueSet->uxSetMembers--;
+
+    return prvQueueCanFree(pxQueueSet);
+}
+
+/*---------------------------------------------------------------------------
+ *  删除队列
+ *
+ *  放出所有等待的任务，它们醒来后返回失败；
+ *  没有任务还在阻塞流程里就直接释放，否则由最后一个离开的任务释放。
+ *  是集合成员就先移出集合；本身是集合且还有成员，等最后一个成员离开后释放
+ *---------------------------------------------------------------------------*/
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    Queue_t *pxQueueSetToFree = NULL;
+    uint32_t xSwitchRequired = 0;
+    uint32_t xFreeNow;
+
+    taskENTER_CRITICAL();
+
+    if (pxQueue->pxQueueSetContainer != NULL)
+    {
+        Queue_t *pxQueueSet = pxQueue->pxQueueSetContainer;
+
+        if (prvRemoveFromSetContainer(pxQueue))
+        {
+            pxQueueSetToFree = pxQueueSet;
+        }
+    }
+
+    while (pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend));
+    }
+
+    while (pxQueue->xTasksWaitingToReceive.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToReceive));
+    }
+
+    /* 被放出来（或者刚被正常唤醒）还没运行的任务醒来后还要访问队列 */
+    pxQueue->uxDeleted = 1;
+    xFreeNow = prvQueueCanFree(pxQueue);
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if (pxQueueSetToFree != NULL)
+    {
+        vPortFree(pxQueueSetToFree);
+    }
+
+    if (xFreeNow)
+    {
+        vPortFree(pxQueue);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  阻塞在队列上（供 mutex.c 使用，必须在临界区内调用）
+ *
+ *  登记等待的任务数，删除队列时据此决定谁来释放内存；
+ *  TCB 里记下队列，任务在阻塞流程里被删除时由 vTaskDelete 撤销登记
+ *---------------------------------------------------------------------------*/
+void prvQueueWaitOnList(Queue_t *pxQueue, List_t *pxWaitList, uint32_t xTicksToWait)
+{
+    pxQueue->uxWaitingTasks++;
+    pxCurrentTCB->pxWaitingOnQueue = pxQueue;
+    vTaskPlaceOnEventList(pxWaitList, xTicksToWait);
+}
+
+/*---------------------------------------------------------------------------
+ *  阻塞返回后撤销登记（供 mutex.c 使用）
+ *
+ *  返回 1 表示等待期间队列被删除，调用者直接返回失败，不能再访问队列；
+ *  最后一个离开的任务负责释放内存
+ *---------------------------------------------------------------------------*/
+uint32_t prvQueueWaitFinished(Queue_t *pxQueue)
+{
+    uint32_t xDeleted;
+    uint32_t xFreeNow;
+
+    taskENTER_CRITICAL();
+
+    pxQueue->uxWaitingTasks--;
+    pxCurrentTCB->pxWaitingOnQueue = NULL;
+    xDeleted = pxQueue->uxDeleted;
+    xFreeNow = prvQueueCanFree(pxQueue);
+
+    taskEXIT_CRITICAL();
+
+    if (xFreeNow)
+    {
+        vPortFree(pxQueue);
+    }
+
+    return xDeleted;
+}
+
+/*---------------------------------------------------------------------------
+ *  任务在阻塞流程里被删除时替它撤销登记（供 task.c 使用，必须在临界区内调用）
+ *
+ *  不撤销的话 uxWaitingTasks 永远降不到 0，队列删除后内存就再也释放不了
+ *---------------------------------------------------------------------------*/
+void prvQueueWaitAbandoned(TCB_t *pxTCB)
+{
+    Queue_t *pxQueue = pxTCB->pxWaitingOnQueue;
+
+    pxTCB->pxWaitingOnQueue = NULL;
+    pxQueue->uxWaitingTasks--;
+
+    /* 队列已经删了，这个任务就是最后一个等待者 */
+    if (prvQueueCanFree(pxQueue))
+    {
+        vPortFree(pxQueue);
+    }
+}
+
 /*---------------------------------------------------------------------------
  *  拷贝数据到队列（内部函数）
+ *
+ *  queueSEND_TO_BACK  : 写在 pcWriteTo，写指针后移
+ *  queueSEND_TO_FRONT : 写在 pcReadFrom（上一个读走的位置，正好在最早的元素前面），读指针前移
+ *  queueOVERWRITE     : 只用于容量为 1 的队列，满时原地覆盖那一个元素
+ *  返回 1 表示元素个数增加了（覆盖已有元素返回 0）
  *---------------------------------------------------------------------------*/
-static void prvCopyDataToQueue(Queue_t *pxQueue, const void *pvItemToQueue)
+static uint32_t prvCopyDataToQueue(Queue_t *pxQueue, const void *pvItemToQueue, uint32_t xCopyPosition)
 {
+    int8_t *pcNextRead;
+
+    if (xCopyPosition == queueOVERWRITE && pxQueue->uxMessagesWaiting > 0)
+    {
+        /* 覆盖下一个要读的元素，个数不变 */
+        if (pxQueue->uxItemSize > 0)
+        {
+            pcNextRead = pxQueue->pcReadFrom + pxQueue->uxItemSize;
+            if (pcNextRead >= pxQueue->pcTail)
+            {
+                pcNextRead = pxQueue->pcHead;
+            }
+            memcpy((void *)pcNextRead, pvItemToQueue, pxQueue->uxItemSize);
+        }
+        return 0;
+    }
+
     /*针对于有数据的情况才进行拷贝，比如消息队列，排除二值信号量和计数信号量*/
     if (pxQueue->uxItemSize > 0)
     {
-        /* 拷贝数据到写入位置 */
-        memcpy((void *)pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize);
-
-        /* 写指针往后移 */
-        pxQueue->pcWriteTo += pxQueue->uxItemSize;
+        if (xCopyPosition == queueSEND_TO_FRONT)
+        {
+            /* 写到最早的元素前面，读指针往前退一格 */
+            memcpy((void *)pxQueue->pcReadFrom, pvItemToQueue, pxQueue->uxItemSize);
 
-        /* 到末尾就绕回开头 */
-        if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+            if (pxQueue->pcReadFrom == pxQueue->pcHead)
+            {
+                pxQueue->pcReadFrom = pxQueue->pcTail - pxQueue->uxItemSize;
+            }
+            else
+            {
+                pxQueue->pcReadFrom -= pxQueue->uxItemSize;
+            }
+        }
+        else
         {
-            pxQueue->pcWriteTo = pxQueue->pcHead;
+            /* 拷贝数据到写入位置 */
+            memcpy((void *)pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize);
+
+            /* 写指针往后移 */
+            pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+            /* 到末尾就绕回开头 */
+            if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+            {
+                pxQueue->pcWriteTo = pxQueue->pcHead;
+            }
         }
     }
 
     /*二值信号量和计数信号量只管将队列元素加加就可以了*/
     pxQueue->uxMessagesWaiting++;
+    return 1;
 }
 
 /*---------------------------------------------------------------------------
@@ -105,45 +325,140 @@ static void prvCopyDataFromQueue(Queue_t *pxQueue, void *pvBuffer)
     pxQueue->uxMessagesWaiting--;
 }
 
+/*---------------------------------------------------------------------------
+ *  判断能否发送/接收（内部函数）
+ *
+ *  被借出的空位/元素还占着位置，借用期间分别对发送者/接收者表现为满/空
+ *---------------------------------------------------------------------------*/
+static uint32_t prvQueueCanSend(Queue_t *pxQueue)
+{
+    return (pxQueue->uxMessagesWaiting < pxQueue->uxLength) && (pxQueue->uxWriteLoan == 0);
+}
+
+static uint32_t prvQueueCanReceive(Queue_t *pxQueue)
+{
+    return (pxQueue->uxMessagesWaiting > 0) && (pxQueue->uxReadLoan == 0);
+}
+
+/*
+ * 按写入位置判断：
+ * 覆盖写不看满不满，只要没有借用；写到队头会移动读指针，读借用期间也不行
+ */
+static uint32_t prvQueueCanWrite(Queue_t *pxQueue, uint32_t xCopyPosition)
+{
+    if (xCopyPosition == queueOVERWRITE)
+    {
+        return (pxQueue->uxWriteLoan == 0) && (pxQueue->uxReadLoan == 0);
+    }
+
+    if (xCopyPosition == queueSEND_TO_FRONT && pxQueue->uxReadLoan != 0)
+    {
+        return 0;
+    }
+
+    return prvQueueCanSend(pxQueue);
+}
+
+/*---------------------------------------------------------------------------
+ *  成员收到一个元素后通知所属集合（内部函数，必须在临界区内调用）
+ *
+ *  把成员句柄放进集合，唤醒阻塞在集合上的任务。
+ *  返回 1 表示被唤醒的任务应该抢占当前任务
+ *---------------------------------------------------------------------------*/
+static uint32_t prvNotifyQueueSetContainer(Queue_t *pxQueue)
+{
+    Queue_t *pxQueueSet = pxQueue->pxQueueSetContainer;
+
+    /* 集合已被删除，没人会再来取，直接丢掉 */
+    if (pxQueueSet->uxDeleted != 0)
+        return 0;
+
+    /* 集合按成员容量之和创建就不会满，满了只能丢掉这次通知 */
+    if (pxQueueSet->uxMessagesWaiting >= pxQueueSet->uxLength)
+        return 0;
+
+    prvCopyDataToQueue(pxQueueSet, &pxQueue, queueSEND_TO_BACK);
+
+    if (pxQueueSet->xTasksWaitingToReceive.uxNumberOfItems > 0)
+    {
+        return xTaskRemoveFromEventList(&(pxQueueSet->xTasksWaitingToReceive));
+    }
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  队列里多了一个元素，唤醒等待接收的任务（内部函数，必须在临界区内调用）
+ *
+ *  Peek 的任务不取走元素，链表上的全部唤醒；
+ *  真正接收的只唤醒第一个（优先级最高的），一个元素只够它一个人拿。
+ *  返回 1 表示被唤醒的任务应该抢占当前任务
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWakeReceivers(Queue_t *pxQueue)
+{
+    List_t *pxList = &(pxQueue->xTasksWaitingToReceive);
+    ListItem_t *pxItem = pxList->xListEnd.pxNext;
+    ListItem_t *pxNext;
+    uint32_t xReceiverWoken = 0;
+    uint32_t xSwitchRequired = 0;
+
+    while ((void *)pxItem != (void *)&(pxList->xListEnd))
+    {
+        pxNext = pxItem->pxNext;
+
+        if (((TCB_t *)pxItem->pvOwner)->ucQueuePeek != 0)
+        {
+            xSwitchRequired |= xTaskRemoveItemFromEventList(pxItem);
+        }
+        else if (xReceiverWoken == 0)
+        {
+            xSwitchRequired |= xTaskRemoveItemFromEventList(pxItem);
+            xReceiverWoken = 1;
+        }
+
+        pxItem = pxNext;
+    }
+
+    return xSwitchRequired;
+}
+
 /*---------------------------------------------------------------------------
  *  发送数据到队列（带阻塞）
+ *
+ *  xQueueSend/xQueueSendToFront/xQueueOverwrite 都走这里，只是写入位置不同
  *---------------------------------------------------------------------------*/
-int32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTicksToWait)
+int32_t xQueueGenericSend(QueueHandle_t xQueue, const void *pvItemToQueue,
+                          uint32_t xTicksToWait, uint32_t xCopyPosition)
 {
     Queue_t *pxQueue = (Queue_t *)xQueue;
+    uint32_t xAdded;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    /* 覆盖写只对容量为 1 的队列有意义 */
+    if (xCopyPosition == queueOVERWRITE && pxQueue->uxLength != 1)
+        return -1;
 
     for (;;)
     {
         taskENTER_CRITICAL();
 
-        if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
+        if (prvQueueCanWrite(pxQueue, xCopyPosition))
         {
-            /* 队列没满，写入 */
-            prvCopyDataToQueue(pxQueue, pvItemToQueue);
+            /* 队列没满（或者覆盖写），写入 */
+            xAdded = prvCopyDataToQueue(pxQueue, pvItemToQueue, xCopyPosition);
 
-            /* 唤醒等待接收的任务 */
-            if (pxQueue->xTasksWaitingToReceive.uxNumberOfItems > 0)
+            /* 属于某个集合时，把自己的句柄放进集合（覆盖已有元素不用再放） */
+            if (xAdded && pxQueue->pxQueueSetContainer != NULL &&
+                prvNotifyQueueSetContainer(pxQueue))
             {
-                ListItem_t *pxItem = pxQueue->xTasksWaitingToReceive.xListEnd.pxNext; /*拿到头结点*/
-                TCB_t *pxTCB = (TCB_t *)pxItem->pvOwner;                              /*拿到对应pcb*/
-
-                /* 从队列等待链表移除 */
-                uxListRemove(pxItem);
-
-                /* 从延时链表移除（如果在的话） */
-                if (pxTCB->xStateListItem.pvContainer != NULL)
-                {
-                    uxListRemove(&(pxTCB->xStateListItem));
-                }
-
-                /* 放回就绪链表 */
-                prvAddTaskToReadyList(pxTCB);
+                portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+            }
 
-                /*如果大于当前优先级触发pendsv中断切换任务*/
-                if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
-                {
-                    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
-                }
+            /* 唤醒等待接收的任务，比当前任务更该运行就触发pendsv中断切换任务 */
+            if (prvWakeReceivers(pxQueue))
+            {
+                portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
             }
 
             taskEXIT_CRITICAL();
@@ -159,29 +474,29 @@ int32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTi
                 return -1;
             }
 
-            /* 阻塞：从就绪链表移除 */
-            prvRemoveTaskFromReadyList(pxCurrentTCB);
-
-            /* 加入队列等待发送链表（用 xEventListItem） */
-            vListInsertEnd(&(pxQueue->xTasksWaitingToSend),
-                           &(pxCurrentTCB->xEventListItem));
-
-            /* 同时加入延时链表（超时机制） */
-            if (xTicksToWait < 0xFFFFFFFFUL)
+            /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+            if (xEntryTimeSet == 0)
             {
-                prvAddCurrentTaskToDelayedList(xTicksToWait);
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = 1;
             }
 
+            /* 阻塞：按优先级加入队列等待发送链表（用 xEventListItem），同时加入延时链表（超时机制） */
+            prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToSend), xTicksToWait);
+
             taskEXIT_CRITICAL();
 
             /* 触发切换 */
             portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
 
-            /*
-             * 被唤醒后回到 for 循环顶部
-             * 重新检查队列，如果还是满的就返回 -1（超时）
-             */
-            xTicksToWait = 0; /*为下一次进入循环判断做准备，下一次要是还是满的直接超时啦，直接返回*/
+            /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+            if (prvQueueWaitFinished(pxQueue))
+            {
+                return -1;
+            }
+
+            /* 被唤醒了但资源可能已被别人抢走：没到超时就带着剩余时间回去再等，真超时了再最后检查一次 */
+            (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
         }
     }
 }
@@ -192,12 +507,14 @@ int32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTi
 int32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
 {
     Queue_t *pxQueue = (Queue_t *)xQueue;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
 
     for (;;)
     {
         taskENTER_CRITICAL();
 
-        if (pxQueue->uxMessagesWaiting > 0)
+        if (prvQueueCanReceive(pxQueue))
         {
             /* 队列有数据，读出来 */
             prvCopyDataFromQueue(pxQueue, pvBuffer);
@@ -205,19 +522,7 @@ int32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWai
             /* 唤醒等待发送的任务 */
             if (pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0)
             {
-                ListItem_t *pxItem = pxQueue->xTasksWaitingToSend.xListEnd.pxNext;
-                TCB_t *pxTCB = (TCB_t *)pxItem->pvOwner;
-
-                uxListRemove(pxItem);
-
-                if (pxTCB->xStateListItem.pvContainer != NULL)
-                {
-                    uxListRemove(&(pxTCB->xStateListItem));
-                }
-
-                prvAddTaskToReadyList(pxTCB);
-
-                if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+                if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)))
                 {
                     portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
                 }
@@ -235,28 +540,711 @@ int32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWai
                 return -1;
             }
 
-            /* 阻塞：从就绪链表移除 */
-            prvRemoveTaskFromReadyList(pxCurrentTCB);
+            /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+            if (xEntryTimeSet == 0)
+            {
+                vTaskSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = 1;
+            }
+
+            /* 阻塞：按优先级加入队列等待接收链表，同时加入延时链表（超时） */
+            prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+
+            taskEXIT_CRITICAL();
+
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+            /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+            if (prvQueueWaitFinished(pxQueue))
+            {
+                return -1;
+            }
+
+            /* 没到超时就按剩余时间继续等 */
+            (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  查看队头元素但不取走（带阻塞）
+ *
+ *  读指针和元素个数都不动，元素还在队列里；
+ *  阻塞时在 TCB 里做 Peek 标记，发送方（prvWakeReceivers）据此把所有 Peek 的任务
+ *  连同第一个真正接收的任务一起唤醒，不会被夹在中间的接收者截断
+ *---------------------------------------------------------------------------*/
+int32_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    int8_t *pcNextRead;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
 
-            /* 加入队列等待接收链表 */
-            vListInsertEnd(&(pxQueue->xTasksWaitingToReceive),
-                           &(pxCurrentTCB->xEventListItem));
+    for (;;)
+    {
+        taskENTER_CRITICAL();
 
-            /* 加入延时链表（超时） */
-            if (xTicksToWait < 0xFFFFFFFFUL)
+        if (prvQueueCanReceive(pxQueue))
+        {
+            if (pxQueue->uxItemSize > 0)
             {
-                prvAddCurrentTaskToDelayedList(xTicksToWait);
+                /* 和 prvCopyDataFromQueue 一样，下一个元素在 pcReadFrom 后面一格 */
+                pcNextRead = pxQueue->pcReadFrom + pxQueue->uxItemSize;
+                if (pcNextRead >= pxQueue->pcTail)
+                {
+                    pcNextRead = pxQueue->pcHead;
+                }
+                memcpy(pvBuffer, (void *)pcNextRead, pxQueue->uxItemSize);
             }
 
             taskEXIT_CRITICAL();
+            return 0;
+        }
 
-            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return -1;
+        }
+
+        /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        /* 和 xQueueReceive 一样等在接收链表上，标记为 Peek，发送方会把 Peek 的任务全部唤醒 */
+        pxCurrentTCB->ucQueuePeek = 1;
+        prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+
+        taskEXIT_CRITICAL();
 
-            xTicksToWait = 0; /*为下一次进入循环判断做准备，下一次要是还是满的直接超时啦，直接返回*/
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 已经不在接收链表上了，标记不再有意义 */
+        pxCurrentTCB->ucQueuePeek = 0;
+
+        /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+        if (prvQueueWaitFinished(pxQueue))
+        {
+            return -1;
         }
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
     }
 }
 
+/*---------------------------------------------------------------------------
+ *  批量发送（带阻塞）
+ *
+ *  一次临界区写入尽可能多的元素，环形缓冲区最多分两段连续拷贝，
+ *  写入几个元素就最多唤醒几个等待接收的任务，整批只触发一次 PendSV。
+ *  队列满时和 xQueueSend 一样阻塞，有空位后能写多少写多少，不等凑满一批
+ *---------------------------------------------------------------------------*/
+int32_t xQueueSendMultiple(QueueHandle_t xQueue, const void *pvItems,
+                           uint32_t uxCount, uint32_t xTicksToWait)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    const int8_t *pcSrc = (const int8_t *)pvItems;
+    uint32_t uxToSend;
+    uint32_t uxFirstRun;
+    uint32_t i;
+    uint32_t xSwitchRequired = 0;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    if (uxCount == 0)
+        return 0;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        if (prvQueueCanSend(pxQueue))
+        {
+            /* 这一批能写多少 */
+            uxToSend = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+            if (uxToSend > uxCount)
+            {
+                uxToSend = uxCount;
+            }
+
+            if (pxQueue->uxItemSize > 0)
+            {
+                /* 第一段：写指针到缓冲区末尾 */
+                uxFirstRun = (uint32_t)(pxQueue->pcTail - pxQueue->pcWriteTo) / pxQueue->uxItemSize;
+                if (uxFirstRun > uxToSend)
+                {
+                    uxFirstRun = uxToSend;
+                }
+                memcpy((void *)pxQueue->pcWriteTo, pcSrc, uxFirstRun * pxQueue->uxItemSize);
+                pxQueue->pcWriteTo += uxFirstRun * pxQueue->uxItemSize;
+
+                if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+                {
+                    pxQueue->pcWriteTo = pxQueue->pcHead;
+                }
+
+                /* 第二段：绕回开头 */
+                if (uxToSend > uxFirstRun)
+                {
+                    memcpy((void *)pxQueue->pcWriteTo, pcSrc + (uxFirstRun * pxQueue->uxItemSize),
+                           (uxToSend - uxFirstRun) * pxQueue->uxItemSize);
+                    pxQueue->pcWriteTo += (uxToSend - uxFirstRun) * pxQueue->uxItemSize;
+                }
+            }
+
+            pxQueue->uxMessagesWaiting += uxToSend;
+
+            /* 集合里每个元素对应一个句柄 */
+            if (pxQueue->pxQueueSetContainer != NULL)
+            {
+                for (i = 0; i < uxToSend; i++)
+                {
+                    xSwitchRequired |= prvNotifyQueueSetContainer(pxQueue);
+                }
+            }
+
+            /* 写入几个元素就最多唤醒几个等待接收的任务（Peek 的第一次就全部唤醒了） */
+            for (i = 0; i < uxToSend && pxQueue->xTasksWaitingToReceive.uxNumberOfItems > 0; i++)
+            {
+                xSwitchRequired |= prvWakeReceivers(pxQueue);
+            }
+
+            /* 整批只触发一次切换 */
+            if (xSwitchRequired)
+            {
+                portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+            }
+
+            taskEXIT_CRITICAL();
+            return (int32_t)uxToSend;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return 0;
+        }
+
+        /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToSend), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+        if (prvQueueWaitFinished(pxQueue))
+        {
+            return 0;
+        }
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  批量接收（带阻塞）
+ *
+ *  一次临界区读出尽可能多的元素（最多 uxCount 个），最多两段连续拷贝，
+ *  腾出几个空位就最多唤醒几个等待发送的任务，整批只触发一次 PendSV
+ *---------------------------------------------------------------------------*/
+int32_t xQueueReceiveMultiple(QueueHandle_t xQueue, void *pvBuffer,
+                              uint32_t uxCount, uint32_t xTicksToWait)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    int8_t *pcDst = (int8_t *)pvBuffer;
+    int8_t *pcReadFrom;
+    uint32_t uxToReceive;
+    uint32_t uxFirstRun;
+    uint32_t i;
+    uint32_t xSwitchRequired = 0;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    if (uxCount == 0)
+        return 0;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        if (prvQueueCanReceive(pxQueue))
+        {
+            uxToReceive = pxQueue->uxMessagesWaiting;
+            if (uxToReceive > uxCount)
+            {
+                uxToReceive = uxCount;
+            }
+
+            if (pxQueue->uxItemSize > 0)
+            {
+                /* pcReadFrom 指向上一个读走的元素，下一个在它后面一格 */
+                pcReadFrom = pxQueue->pcReadFrom + pxQueue->uxItemSize;
+                if (pcReadFrom >= pxQueue->pcTail)
+                {
+                    pcReadFrom = pxQueue->pcHead;
+                }
+
+                /* 第一段：读位置到缓冲区末尾 */
+                uxFirstRun = (uint32_t)(pxQueue->pcTail - pcReadFrom) / pxQueue->uxItemSize;
+                if (uxFirstRun > uxToReceive)
+                {
+                    uxFirstRun = uxToReceive;
+                }
+                memcpy(pcDst, (void *)pcReadFrom, uxFirstRun * pxQueue->uxItemSize);
+                pcReadFrom += uxFirstRun * pxQueue->uxItemSize;
+
+                /* 第二段：绕回开头 */
+                if (uxToReceive > uxFirstRun)
+                {
+                    pcReadFrom = pxQueue->pcHead;
+                    memcpy(pcDst + (uxFirstRun * pxQueue->uxItemSize), (void *)pcReadFrom,
+                           (uxToReceive - uxFirstRun) * pxQueue->uxItemSize);
+                    pcReadFrom += (uxToReceive - uxFirstRun) * pxQueue->uxItemSize;
+                }
+
+                /* 保持 pcReadFrom 指向最后一个读走的元素 */
+                pxQueue->pcReadFrom = pcReadFrom - pxQueue->uxItemSize;
+            }
+
+            pxQueue->uxMessagesWaiting -= uxToReceive;
+
+            /* 腾出几个空位就最多唤醒几个等待发送的任务 */
+            for (i = 0; i < uxToReceive && pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0; i++)
+            {
+                xSwitchRequired |= xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend));
+            }
+
+            /* 整批只触发一次切换 */
+            if (xSwitchRequired)
+            {
+                portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+            }
+
+            taskEXIT_CRITICAL();
+            return (int32_t)uxToReceive;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return 0;
+        }
+
+        /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+        if (prvQueueWaitFinished(pxQueue))
+        {
+            return 0;
+        }
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中发送数据到队列（不阻塞）
+ *
+ *  写入位置同 xQueueGenericSend；队列满直接返回 -1；唤醒了比当前任务更该运行的任务时
+ *  只把 *pxHigherPriorityTaskWoken 置 1，不触发 PendSV，
+ *  由中断退出前调用 portYIELD_FROM_ISR() 统一切换一次
+ *---------------------------------------------------------------------------*/
+int32_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue,
+                                 uint32_t *pxHigherPriorityTaskWoken, uint32_t xCopyPosition)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    uint32_t ulSavedInterruptStatus;
+    uint32_t xAdded;
+    int32_t xReturn = -1;
+
+    if (xCopyPosition == queueOVERWRITE && pxQueue->uxLength != 1)
+        return -1;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    if (prvQueueCanWrite(pxQueue, xCopyPosition))
+    {
+        xAdded = prvCopyDataToQueue(pxQueue, pvItemToQueue, xCopyPosition);
+
+        if (xAdded && pxQueue->pxQueueSetContainer != NULL &&
+            prvNotifyQueueSetContainer(pxQueue) &&
+            pxHigherPriorityTaskWoken != NULL)
+        {
+            *pxHigherPriorityTaskWoken = 1;
+        }
+
+        if (prvWakeReceivers(pxQueue) && pxHigherPriorityTaskWoken != NULL)
+        {
+            *pxHigherPriorityTaskWoken = 1;
+        }
+
+        xReturn = 0;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    return xReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中从队列接收数据（不阻塞）
+ *---------------------------------------------------------------------------*/
+int32_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer,
+                             uint32_t *pxHigherPriorityTaskWoken)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    uint32_t ulSavedInterruptStatus;
+    int32_t xReturn = -1;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    if (prvQueueCanReceive(pxQueue))
+    {
+        prvCopyDataFromQueue(pxQueue, pvBuffer);
+
+        if (pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0)
+        {
+            if (xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend)) &&
+                pxHigherPriorityTaskWoken != NULL)
+            {
+                *pxHigherPriorityTaskWoken = 1;
+            }
+        }
+
+        xReturn = 0;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    return xReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  借出下一个空位（写借用，带阻塞）
+ *
+ *  只在临界区里登记借用，数据由生产者在临界区外直接写进队列缓冲区
+ *---------------------------------------------------------------------------*/
+void *pvQueueLoanWrite(QueueHandle_t xQueue, uint32_t xTicksToWait)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    void *pvSlot;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    /* 信号量没有数据区，不能借 */
+    if (pxQueue->uxItemSize == 0)
+        return NULL;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        if (prvQueueCanSend(pxQueue))
+        {
+            /* pcWriteTo 就是下一个空位，借用期间其他发送者不会动它 */
+            pxQueue->uxWriteLoan = 1;
+            pvSlot = (void *)pxQueue->pcWriteTo;
+
+            taskEXIT_CRITICAL();
+            return pvSlot;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return NULL;
+        }
+
+        /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        /* 满了或者空位已经借出去了，和 xQueueSend 一样等在发送链表上 */
+        prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToSend), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+        if (prvQueueWaitFinished(pxQueue))
+        {
+            return NULL;
+        }
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  提交写借用：借出的空位变成队列里的一个元素
+ *---------------------------------------------------------------------------*/
+int32_t xQueueCommitWrite(QueueHandle_t xQueue)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    uint32_t xSwitchRequired = 0;
+
+    taskENTER_CRITICAL();
+
+    if (pxQueue->uxWriteLoan == 0)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    /* 和 prvCopyDataToQueue 一样移动写指针，只是不拷贝 */
+    pxQueue->pcWriteTo += pxQueue->uxItemSize;
+    if (pxQueue->pcWriteTo >= pxQueue->pcTail)
+    {
+        pxQueue->pcWriteTo = pxQueue->pcHead;
+    }
+    pxQueue->uxMessagesWaiting++;
+    pxQueue->uxWriteLoan = 0;
+
+    if (pxQueue->pxQueueSetContainer != NULL)
+    {
+        xSwitchRequired |= prvNotifyQueueSetContainer(pxQueue);
+    }
+
+    /* 唤醒等待接收的任务 */
+    xSwitchRequired |= prvWakeReceivers(pxQueue);
+
+    /* 因为空位被借出而等待的发送者，还有空位就放一个出来 */
+    if (prvQueueCanSend(pxQueue) && pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend));
+    }
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    taskEXIT_CRITICAL();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  借出最早的元素（读借用，带阻塞）
+ *
+ *  元素留在队列里继续占着位置，归还之前生产者不会覆盖它
+ *---------------------------------------------------------------------------*/
+void *pvQueueLoanRead(QueueHandle_t xQueue, uint32_t xTicksToWait)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    int8_t *pcSlot;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    if (pxQueue->uxItemSize == 0)
+        return NULL;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        if (prvQueueCanReceive(pxQueue))
+        {
+            /* 和 prvCopyDataFromQueue 一样，下一个元素在 pcReadFrom 后面一格 */
+            pcSlot = pxQueue->pcReadFrom + pxQueue->uxItemSize;
+            if (pcSlot >= pxQueue->pcTail)
+            {
+                pcSlot = pxQueue->pcHead;
+            }
+            pxQueue->uxReadLoan = 1;
+
+            taskEXIT_CRITICAL();
+            return (void *)pcSlot;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return NULL;
+        }
+
+        /* 第一次阻塞时记下起点，之后按剩余时间继续等 */
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        /* 空了或者元素已经借出去了，和 xQueueReceive 一样等在接收链表上 */
+        prvQueueWaitOnList(pxQueue, &(pxQueue->xTasksWaitingToReceive), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 被唤醒后撤销等待登记，等待期间队列被删除就直接失败 */
+        if (prvQueueWaitFinished(pxQueue))
+        {
+            return NULL;
+        }
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  归还读借用：借出的元素出队，空出一个位置
+ *---------------------------------------------------------------------------*/
+int32_t xQueueReleaseRead(QueueHandle_t xQueue)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueue;
+    uint32_t xSwitchRequired = 0;
+
+    taskENTER_CRITICAL();
+
+    if (pxQueue->uxReadLoan == 0)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    /* 和 prvCopyDataFromQueue 一样移动读指针，只是不拷贝 */
+    pxQueue->pcReadFrom += pxQueue->uxItemSize;
+    if (pxQueue->pcReadFrom >= pxQueue->pcTail)
+    {
+        pxQueue->pcReadFrom = pxQueue->pcHead;
+    }
+    pxQueue->uxMessagesWaiting--;
+    pxQueue->uxReadLoan = 0;
+
+    /* 唤醒等待发送的任务 */
+    if (pxQueue->xTasksWaitingToSend.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= xTaskRemoveFromEventList(&(pxQueue->xTasksWaitingToSend));
+    }
+
+    /* 因为元素被借出而等待的接收者，还有元素就放一个出来 */
+    if (prvQueueCanReceive(pxQueue))
+    {
+        xSwitchRequired |= prvWakeReceivers(pxQueue);
+    }
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    taskEXIT_CRITICAL();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  创建队列集合
+ *
+ *  集合就是一个元素为队列句柄的队列
+ *---------------------------------------------------------------------------*/
+QueueSetHandle_t xQueueCreateSet(uint32_t uxEventQueueLength)
+{
+    return xQueueCreate(uxEventQueueLength, sizeof(Queue_t *));
+}
+
+/*---------------------------------------------------------------------------
+ *  加入集合
+ *
+ *  成员非空时集合里没有对应的句柄，加进去会漏掉已有的元素，所以要求为空
+ *---------------------------------------------------------------------------*/
+int32_t xQueueAddToSet(QueueHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueueOrSemaphore;
+    int32_t xReturn = -1;
+
+    taskENTER_CRITICAL();
+
+    if (pxQueue->pxQueueSetContainer == NULL && pxQueue->uxMessagesWaiting == 0)
+    {
+        pxQueue->pxQueueSetContainer = xQueueSet;
+        xQueueSet->uxSetMembers++;
+        xReturn = 0;
+    }
+
+    taskEXIT_CRITICAL();
+    return xReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  移出集合
+ *
+ *  成员非空时集合里还有它的句柄，移出后句柄就失效了，所以要求为空
+ *---------------------------------------------------------------------------*/
+int32_t xQueueRemoveFromSet(QueueHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet)
+{
+    Queue_t *pxQueue = (Queue_t *)xQueueOrSemaphore;
+    uint32_t xFreeSet = 0;
+    int32_t xReturn = -1;
+
+    taskENTER_CRITICAL();
+
+    if (pxQueue->pxQueueSetContainer == xQueueSet && pxQueue->uxMessagesWaiting == 0)
+    {
+        /* 成员为空时集合里没有它的句柄，只是减成员数；集合已删除时最后一个成员负责释放 */
+        xFreeSet = prvRemoveFromSetContainer(pxQueue);
+        xReturn = 0;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if (xFreeSet)
+    {
+        vPortFree(xQueueSet);
+    }
+
+    return xReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  等待集合里任意一个成员可读（带阻塞）
+ *---------------------------------------------------------------------------*/
+QueueHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet, uint32_t xTicksToWait)
+{
+    QueueHandle_t xMember = NULL;
+
+    (void)xQueueReceive(xQueueSet, &xMember, xTicksToWait);
+
+    return xMember;
+}
+
+QueueHandle_t xQueueSelectFromSetFromISR(QueueSetHandle_t xQueueSet,
+                                         uint32_t *pxHigherPriorityTaskWoken)
+{
+    QueueHandle_t xMember = NULL;
+
+    (void)xQueueReceiveFromISR(xQueueSet, &xMember, pxHigherPriorityTaskWoken);
+
+    return xMember;
+}
+
 /*---------------------------------------------------------------------------
  *  查询队列元素个数
  *---------------------------------------------------------------------------*/
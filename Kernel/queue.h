@@ -5,11 +5,14 @@
 #include "list.h"
 #include "task.h"
 
-/* 供 queue.c 使用 */
+/* 供 queue.c 等内核对象使用 */
 extern TCB_t *volatile pxCurrentTCB;
 void prvAddTaskToReadyList(TCB_t *pxTCB);
 void prvRemoveTaskFromReadyList(TCB_t *pxTCB);
 void prvAddCurrentTaskToDelayedList(uint32_t xTicksToDelay);
+void vTaskPlaceOnEventList(List_t *pxEventList, uint32_t xTicksToWait);
+uint32_t xTaskRemoveFromEventList(List_t *pxEventList);
+uint32_t xTaskRemoveItemFromEventList(ListItem_t *pxEventListItem);
 extern volatile uint32_t xTickCount;
 
 #define portMAX_DELAY 0xFFFFFFFF /*死等阻塞，当阻塞时间为0xFFFFFFFF 时不会加入阻塞队列，只会在队列等待队列里面等待唤醒*/
@@ -28,8 +31,17 @@ typedef struct QueueDefinition
     uint32_t uxItemSize;                 /* 每个元素的大小（字节） */
     volatile uint32_t uxMessagesWaiting; /* 当前队列中的元素个数 */
 
+    uint32_t uxWriteLoan; /* 1：pcWriteTo 处的空位借给了生产者，还没提交 */
+    uint32_t uxReadLoan;  /* 1：下一个元素借给了消费者，还没归还 */
+
+    uint32_t uxWaitingTasks; /* 阻塞在这个队列上、还没从阻塞流程返回的任务数 */
+    uint32_t uxDeleted;      /* 1：已被删除，等最后一个等待的任务离开后释放 */
+
     List_t xTasksWaitingToSend;    /* 等待发送的任务链表 */
     List_t xTasksWaitingToReceive; /* 等待接收的任务链表 */
+
+    struct QueueDefinition *pxQueueSetContainer; /* 所属的队列集合，没有加入集合为 NULL */
+    uint32_t uxSetMembers;                       /* 作为集合时还挂着的成员数，删除集合后等它归零再释放 */
 } Queue_t;
 
 /*---------------------------------------------------------------------------
@@ -37,6 +49,9 @@ typedef struct QueueDefinition
  *---------------------------------------------------------------------------*/
 typedef Queue_t *QueueHandle_t;
 
+/* 队列集合句柄（本质也是队列，元素是成员的句柄） */
+typedef Queue_t *QueueSetHandle_t;
+
 /*---------------------------------------------------------------------------
  *  API
  *---------------------------------------------------------------------------*/
@@ -49,14 +64,41 @@ typedef Queue_t *QueueHandle_t;
  */
 QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize);
 
+/*
+ * 删除队列（控制块和缓冲区一起释放）
+ *   阻塞在队列上的任务全部放出来，它们的发送/接收返回失败
+ */
+void vQueueDelete(QueueHandle_t xQueue);
+
+/* xQueueGenericSend 的写入位置 */
+#define queueSEND_TO_BACK  0 /* 队尾（FIFO） */
+#define queueSEND_TO_FRONT 1 /* 队头，下一个就被读到 */
+#define queueOVERWRITE     2 /* 覆盖（只用于容量为 1 的队列） */
+
 /*
  * 发送数据到队列
  *   xQueue        : 队列句柄
  *   pvItemToQueue : 要发送的数据指针
  *   xTicksToWait  : 队列满时最多等多少 tick（0 = 不等）
+ *   xCopyPosition : queueSEND_TO_BACK / queueSEND_TO_FRONT / queueOVERWRITE
  *   返回          : 0 成功，-1 失败（超时）
  */
-int32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTicksToWait);
+int32_t xQueueGenericSend(QueueHandle_t xQueue, const void *pvItemToQueue,
+                          uint32_t xTicksToWait, uint32_t xCopyPosition);
+
+#define xQueueSend(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_BACK)
+
+#define xQueueSendToBack(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_BACK)
+
+/* 插到队头（紧急消息），下一次接收就拿到它 */
+#define xQueueSendToFront(xQueue, pvItemToQueue, xTicksToWait) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), (xTicksToWait), queueSEND_TO_FRONT)
+
+/* 邮箱：容量为 1 的队列，有旧值就直接覆盖，从不阻塞（容量不为 1 返回 -1） */
+#define xQueueOverwrite(xQueue, pvItemToQueue) \
+    xQueueGenericSend((xQueue), (pvItemToQueue), 0, queueOVERWRITE)
 
 /*
  * 从队列接收数据
@@ -67,9 +109,92 @@ int32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTi
  */
 int32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait);
 
+/*
+ * 查看队头元素但不取走，参数和返回值同 xQueueReceive
+ *   多个任务同时 Peek 时，一次发送会把它们全部唤醒，
+ *   另外再唤醒一个真正等接收的任务（优先级最高的那个）
+ */
+int32_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait);
+
+/*
+ * 批量发送/接收：一次临界区搬运最多 uxCount 个元素，搬了几个就最多唤醒几个等待任务，只切换一次
+ *   pvItems/pvBuffer : 连续存放的 uxCount 个元素
+ *   xTicksToWait     : 队列满/空时最多等多少 tick，有空位/元素后能搬多少搬多少
+ *   返回             : 实际发送/接收的元素个数，超时返回 0
+ */
+int32_t xQueueSendMultiple(QueueHandle_t xQueue, const void *pvItems,
+                           uint32_t uxCount, uint32_t xTicksToWait);
+int32_t xQueueReceiveMultiple(QueueHandle_t xQueue, void *pvBuffer,
+                              uint32_t uxCount, uint32_t xTicksToWait);
+
+/*
+ * 在中断中发送/接收（不阻塞，中断优先级数值必须 >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY）
+ *   pxHigherPriorityTaskWoken : 唤醒了更该运行的任务时置 1（调用前先清 0，可传 NULL）
+ *                               中断退出前调用 portYIELD_FROM_ISR(*pxHigherPriorityTaskWoken)
+ *   返回                      : 0 成功，-1 队列满/空
+ */
+int32_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue,
+                                 uint32_t *pxHigherPriorityTaskWoken, uint32_t xCopyPosition);
+
+#define xQueueSendFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((xQueue), (pvItemToQueue), (pxHigherPriorityTaskWoken), queueSEND_TO_BACK)
+
+#define xQueueSendToFrontFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((xQueue), (pvItemToQueue), (pxHigherPriorityTaskWoken), queueSEND_TO_FRONT)
+
+#define xQueueOverwriteFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken) \
+    xQueueGenericSendFromISR((xQueue), (pvItemToQueue), (pxHigherPriorityTaskWoken), queueOVERWRITE)
+
+int32_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer,
+                             uint32_t *pxHigherPriorityTaskWoken);
+
+/*
+ * 零拷贝借用（大元素用，数据直接在队列缓冲区里读写，不经过 memcpy）
+ *
+ * 写借用：pvQueueLoanWrite 借出下一个空位，生产者原地填好后 xQueueCommitWrite 提交
+ * 读借用：pvQueueLoanRead 借出最早的元素，消费者原地用完后 xQueueReleaseRead 归还
+ *
+ * 每个队列同一时刻最多一个写借用和一个读借用；
+ * 写借用期间队列对其他发送者表现为满，读借用期间对其他接收者表现为空
+ *   xTicksToWait : 没有空位/元素（或已被借出）时最多等多少 tick
+ *   返回         : 借出的元素地址，超时或元素大小为 0（信号量）时返回 NULL
+ * 提交/归还返回 0 成功，-1 没有对应的借用
+ */
+void *pvQueueLoanWrite(QueueHandle_t xQueue, uint32_t xTicksToWait);
+int32_t xQueueCommitWrite(QueueHandle_t xQueue);
+void *pvQueueLoanRead(QueueHandle_t xQueue, uint32_t xTicksToWait);
+int32_t xQueueReleaseRead(QueueHandle_t xQueue);
+
+/*
+ * 队列集合：一个任务同时阻塞在多个队列/信号量上
+ *
+ * 成员每收到一个元素，就把自己的句柄放进集合一次，
+ * xQueueSelectFromSet 取出句柄后再用 xQueueReceive/xSemaphoreTake（xTicksToWait = 0）去读这个成员。
+ * 没有加入集合的队列发送时只多一次判空，没有其他开销
+ *
+ *   uxEventQueueLength : 集合容量，必须不小于所有成员容量之和，否则满了的通知会丢
+ *   加入/移出集合时成员必须是空的，一个成员只能属于一个集合；互斥量不能加入集合。
+ *   删除成员时自动移出集合，集合里它的句柄一并清掉；
+ *   删除集合后成员的通知直接丢弃，集合内存等最后一个成员移出或删除后才释放
+ *   加入/移出返回 0 成功，-1 失败；Select 超时返回 NULL
+ */
+QueueSetHandle_t xQueueCreateSet(uint32_t uxEventQueueLength);
+int32_t xQueueAddToSet(QueueHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet);
+int32_t xQueueRemoveFromSet(QueueHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet);
+QueueHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet, uint32_t xTicksToWait);
+QueueHandle_t xQueueSelectFromSetFromISR(QueueSetHandle_t xQueueSet,
+                                         uint32_t *pxHigherPriorityTaskWoken);
+
 /*
  * 查询队列中当前有多少元素
  */
 uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
 
+/* 供 mutex.c 使用：阻塞登记，配合 vQueueDelete/vMutexDelete 放出等待的任务 */
+void prvQueueWaitOnList(Queue_t *pxQueue, List_t *pxWaitList, uint32_t xTicksToWait);
+uint32_t prvQueueWaitFinished(Queue_t *pxQueue);
+
+/* 供 task.c 使用：删除还在阻塞流程里的任务时撤销它的等待登记 */
+void prvQueueWaitAbandoned(TCB_t *pxTCB);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "rwlock.h"
+#include "heap.h"
+
+/*---------------------------------------------------------------------------
+ *  创建读写锁
+ *---------------------------------------------------------------------------*/
+RWLockHandle_t xRWLockCreate(void)
+{
+    RWLock_t *pxRWLock;
+    uint32_t i;
+
+    pxRWLock = (RWLock_t *)pvPortMalloc(sizeof(RWLock_t));
+    if (pxRWLock == NULL)
+        return NULL;
+
+    pxRWLock->uxReaders = 0;
+    pxRWLock->pxWriter = NULL;
+    pxRWLock->uxWriterOriginalPriority = 0;
+    pxRWLock->uxWritersWaiting = 0;
+    pxRWLock->uxUntrackedReaders = 0;
+    for (i = 0; i < configRWLOCK_MAX_TRACKED_READERS; i++)
+    {
+        pxRWLock->xReaders[i].pxTask = NULL;
+        pxRWLock->xReaders[i].uxHoldCount = 0;
+        pxRWLock->xReaders[i].uxOriginalPriority = 0;
+    }
+    vListInit(&(pxRWLock->xReadersWaiting));
+    vListInit(&(pxRWLock->xWritersWaiting));
+
+    return pxRWLock;
+}
+
+/*---------------------------------------------------------------------------
+ *  删除读写锁
+ *---------------------------------------------------------------------------*/
+void vRWLockDelete(RWLockHandle_t xRWLock)
+{
+    vPortFree(xRWLock);
+}
+
+/*---------------------------------------------------------------------------
+ *  挡住当前任务的持有者继承当前任务的优先级（内部函数，必须在临界区内调用）
+ *
+ *  写者持有时提升写者；否则是读者持有，提升读者表里所有比当前任务低的读者
+ *---------------------------------------------------------------------------*/
+static void prvInheritPriority(RWLock_t *pxRWLock)
+{
+    TCB_t *pxReader;
+    uint32_t i;
+
+    if (pxRWLock->pxWriter != NULL)
+    {
+        if (pxRWLock->pxWriter->uxPriority < pxCurrentTCB->uxPriority)
+        {
+            vTaskPrioritySet(pxRWLock->pxWriter, pxCurrentTCB->uxPriority);
+        }
+        return;
+    }
+
+    for (i = 0; i < configRWLOCK_MAX_TRACKED_READERS; i++)
+    {
+        pxReader = pxRWLock->xReaders[i].pxTask;
+
+        if (pxReader != NULL && pxReader->uxPriority < pxCurrentTCB->uxPriority)
+        {
+            vTaskPrioritySet(pxReader, pxCurrentTCB->uxPriority);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  在读者表里找当前任务（内部函数，必须在临界区内调用）
+ *
+ *  返回 NULL 表示当前任务没有登记过读锁
+ *---------------------------------------------------------------------------*/
+static RWLockReader_t *prvFindReader(RWLock_t *pxRWLock)
+{
+    uint32_t i;
+
+    for (i = 0; i < configRWLOCK_MAX_TRACKED_READERS; i++)
+    {
+        if (pxRWLock->xReaders[i].pxTask == pxCurrentTCB)
+        {
+            return &(pxRWLock->xReaders[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------
+ *  在读者表里登记当前任务（内部函数，必须在临界区内调用）
+ *
+ *  调用前已确认当前任务没有登记过；表满了只记个数，这个读者不参与优先级继承
+ *---------------------------------------------------------------------------*/
+static void prvAddReader(RWLock_t *pxRWLock)
+{
+    uint32_t i;
+
+    for (i = 0; i < configRWLOCK_MAX_TRACKED_READERS; i++)
+    {
+        if (pxRWLock->xReaders[i].pxTask == NULL)
+        {
+            pxRWLock->xReaders[i].pxTask = pxCurrentTCB;
+            pxRWLock->xReaders[i].uxHoldCount = 1;
+            pxRWLock->xReaders[i].uxOriginalPriority = pxCurrentTCB->uxPriority;
+            return;
+        }
+    }
+
+    pxRWLock->uxUntrackedReaders++;
+}
+
+/*---------------------------------------------------------------------------
+ *  注销当前任务的一层读锁（内部函数，必须在临界区内调用）
+ *
+ *  登记过的最后一次解读锁时恢复继承来的优先级；
+ *  没登记过就算作表满时进来的读者；两样都没有说明调用者没持有读锁，返回 -1
+ *---------------------------------------------------------------------------*/
+static int32_t prvRemoveReader(RWLock_t *pxRWLock)
+{
+    RWLockReader_t *pxReader = prvFindReader(pxRWLock);
+
+    if (pxReader == NULL)
+    {
+        if (pxRWLock->uxUntrackedReaders == 0)
+        {
+            return -1;
+        }
+
+        pxRWLock->uxUntrackedReaders--;
+        return 0;
+    }
+
+    pxReader->uxHoldCount--;
+
+    if (pxReader->uxHoldCount == 0)
+    {
+        if (pxCurrentTCB->uxPriority != pxReader->uxOriginalPriority)
+        {
+            vTaskPrioritySet(pxCurrentTCB, pxReader->uxOriginalPriority);
+        }
+
+        pxReader->pxTask = NULL;
+    }
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  放出所有等读锁的任务（内部函数，必须在临界区内调用）
+ *
+ *  返回 1 表示有被唤醒的任务应该抢占当前任务
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWakeAllReaders(RWLock_t *pxRWLock)
+{
+    uint32_t xSwitchRequired = 0;
+
+    while (pxRWLock->xReadersWaiting.uxNumberOfItems > 0)
+    {
+        xSwitchRequired |= xTaskRemoveFromEventList(&(pxRWLock->xReadersWaiting));
+    }
+
+    return xSwitchRequired;
+}
+
+/*---------------------------------------------------------------------------
+ *  加读锁（带阻塞）
+ *
+ *  没有写者持有、也没有写者在等就直接拿到，只改计数；
+ *  已经持有读锁的任务重入时不看写者，否则等待的写者要等它解锁，它又在等写者，互相卡死
+ *---------------------------------------------------------------------------*/
+int32_t xRWLockReadLock(RWLockHandle_t xRWLock, uint32_t xTicksToWait)
+{
+    RWLock_t *pxRWLock = (RWLock_t *)xRWLock;
+    RWLockReader_t *pxReader;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        /* 重入：读者表里已经有自己，直接加一层 */
+        pxReader = prvFindReader(pxRWLock);
+        if (pxReader != NULL)
+        {
+            pxReader->uxHoldCount++;
+            pxRWLock->uxReaders++;
+
+            taskEXIT_CRITICAL();
+            return 0;
+        }
+
+        /* 写者优先：有写者在等也不能插队 */
+        if (pxRWLock->pxWriter == NULL && pxRWLock->uxWritersWaiting == 0)
+        {
+            pxRWLock->uxReaders++;
+            prvAddReader(pxRWLock);
+
+            taskEXIT_CRITICAL();
+            return 0;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            taskEXIT_CRITICAL();
+            return -1;
+        }
+
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+        }
+
+        prvInheritPriority(pxRWLock);
+
+        vTaskPlaceOnEventList(&(pxRWLock->xReadersWaiting), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  解读锁
+ *
+ *  恢复继承来的优先级，最后一个读者离开时才唤醒一个等写锁的任务
+ *---------------------------------------------------------------------------*/
+int32_t xRWLockReadUnlock(RWLockHandle_t xRWLock)
+{
+    RWLock_t *pxRWLock = (RWLock_t *)xRWLock;
+
+    taskENTER_CRITICAL();
+
+    /* 调用者不在读者表里，也没有未登记的读锁，说明它没持有读锁 */
+    if (prvRemoveReader(pxRWLock) != 0)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    pxRWLock->uxReaders--;
+
+    if (pxRWLock->uxReaders == 0 && pxRWLock->xWritersWaiting.uxNumberOfItems > 0)
+    {
+        if (xTaskRemoveFromEventList(&(pxRWLock->xWritersWaiting)))
+        {
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+        }
+    }
+
+    taskEXIT_CRITICAL();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+ *  加写锁（带阻塞）
+ *
+ *  从第一次阻塞到离开都算在 uxWritersWaiting 里，
+ *  这段时间新来的读者都要排队，被唤醒后不会被读者抢先
+ *---------------------------------------------------------------------------*/
+int32_t xRWLockWriteLock(RWLockHandle_t xRWLock, uint32_t xTicksToWait)
+{
+    RWLock_t *pxRWLock = (RWLock_t *)xRWLock;
+    TimeOut_t xTimeOut;
+    uint32_t xEntryTimeSet = 0;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+
+        if (pxRWLock->pxWriter == NULL && pxRWLock->uxReaders == 0)
+        {
+            pxRWLock->pxWriter = pxCurrentTCB;
+            pxRWLock->uxWriterOriginalPriority = pxCurrentTCB->uxPriority;
+
+            if (xEntryTimeSet != 0)
+            {
+                pxRWLock->uxWritersWaiting--;
+            }
+
+            taskEXIT_CRITICAL();
+            return 0;
+        }
+
+        if (xTicksToWait == 0)
+        {
+            if (xEntryTimeSet != 0)
+            {
+                pxRWLock->uxWritersWaiting--;
+
+                /* 最后一个等待的写者超时走了，被它挡住的读者可以进来了 */
+                if (pxRWLock->uxWritersWaiting == 0 && pxRWLock->pxWriter == NULL &&
+                    prvWakeAllReaders(pxRWLock))
+                {
+                    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+                }
+            }
+
+            taskEXIT_CRITICAL();
+            return -1;
+        }
+
+        if (xEntryTimeSet == 0)
+        {
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = 1;
+            pxRWLock->uxWritersWaiting++;
+        }
+
+        prvInheritPriority(pxRWLock);
+
+        vTaskPlaceOnEventList(&(pxRWLock->xWritersWaiting), xTicksToWait);
+
+        taskEXIT_CRITICAL();
+
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        /* 没到超时就按剩余时间继续等 */
+        (void)xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  解写锁
+ *
+ *  恢复继承来的优先级；还有写者在等就交给下一个写者，否则放出所有读者
+ *---------------------------------------------------------------------------*/
+int32_t xRWLockWriteUnlock(RWLockHandle_t xRWLock)
+{
+    RWLock_t *pxRWLock = (RWLock_t *)xRWLock;
+    uint32_t xSwitchRequired = 0;
+
+    taskENTER_CRITICAL();
+
+    if (pxRWLock->pxWriter != pxCurrentTCB)
+    {
+        taskEXIT_CRITICAL();
+        return -1;
+    }
+
+    if (pxCurrentTCB->uxPriority != pxRWLock->uxWriterOriginalPriority)
+    {
+        vTaskPrioritySet(pxCurrentTCB, pxRWLock->uxWriterOriginalPriority);
+    }
+
+    pxRWLock->pxWriter = NULL;
+
+    if (pxRWLock->xWritersWaiting.uxNumberOfItems > 0)
+    {
+        xSwitchRequired = xTaskRemoveFromEventList(&(pxRWLock->xWritersWaiting));
+    }
+    else if (pxRWLock->uxWritersWaiting == 0)
+    {
+        /* 所有读者一次放出来，最多触发一次 PendSV */
+        xSwitchRequired = prvWakeAllReaders(pxRWLock);
+    }
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    taskEXIT_CRITICAL();
+    return 0;
+}
\ No newline at end of file
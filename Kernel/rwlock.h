@@ -0,0 +1,81 @@
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <stdint.h>
+#include "queue.h"
+#include "task.h"
+
+/*读写锁配置宏*/
+#ifndef configRWLOCK_MAX_TRACKED_READERS
+#define configRWLOCK_MAX_TRACKED_READERS 4 /* 每把锁记录的读者个数（优先级继承用），超出的读者照样能拿锁，只是不继承 */
+#endif
+
+/* 一个持有读锁的任务 */
+typedef struct RWLockReader
+{
+    TCB_t *pxTask;               /* 持有读锁的任务，NULL 表示空位 */
+    uint32_t uxHoldCount;        /* 同一个任务重复加读锁的次数 */
+    uint32_t uxOriginalPriority; /* 第一次加读锁时的优先级（优先级继承用） */
+} RWLockReader_t;
+
+/*---------------------------------------------------------------------------
+ *  读写锁结构
+ *
+ *  多个读者可以同时持有，写者独占；写者优先：
+ *  有写者在等时新来的读者也要排队，读多写少时写者不会被饿死。
+ *  没有竞争时加/解读锁只改计数和读者表，不碰等待链表
+ *---------------------------------------------------------------------------*/
+typedef struct RWLock
+{
+    uint32_t uxReaders;                /* 当前持有读锁的任务数 */
+    TCB_t *pxWriter;                   /* 持有写锁的任务，NULL 表示没有 */
+    uint32_t uxWriterOriginalPriority; /* 写者的原始优先级（优先级继承用） */
+    uint32_t uxWritersWaiting;         /* 正在等写锁的任务数（包括已被唤醒还没拿到锁的） */
+    RWLockReader_t xReaders[configRWLOCK_MAX_TRACKED_READERS]; /* 持有读锁的任务 */
+    uint32_t uxUntrackedReaders;       /* 读者表满时进来、没有登记的读锁数 */
+    List_t xReadersWaiting;            /* 等读锁的任务，按优先级排序 */
+    List_t xWritersWaiting;            /* 等写锁的任务，按优先级排序 */
+} RWLock_t;
+
+typedef RWLock_t *RWLockHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建读写锁
+ *   返回 : 句柄，失败返回 NULL
+ */
+RWLockHandle_t xRWLockCreate(void);
+
+/*
+ * 删除读写锁，调用前不能再有任务持有或等待它
+ */
+void vRWLockDelete(RWLockHandle_t xRWLock);
+
+/*
+ * 加读锁 / 加写锁
+ *   xTicksToWait : 拿不到锁时最多等多少 tick
+ *   返回         : 0 成功，-1 超时
+ *
+ * 被写者挡住时，持有写锁的任务继承等待者的优先级；
+ * 被读者挡住时（包括读者排在等待的写者后面），读者表里的读者都继承等待者的优先级，
+ * 各自解读锁时恢复；读者表满了以后进来的读者不继承。
+ * 读锁可以重入：读者表里的任务再加读锁直接成功，不排在等待的写者后面；
+ * 表满时进来的读者没有登记，不能重入，有写者在等时再加读锁会和写者互相卡死
+ */
+int32_t xRWLockReadLock(RWLockHandle_t xRWLock, uint32_t xTicksToWait);
+int32_t xRWLockWriteLock(RWLockHandle_t xRWLock, uint32_t xTicksToWait);
+
+/*
+ * 解读锁 / 解写锁
+ *   返回 : 0 成功，-1 当前没有持有对应的锁
+ *
+ * 解读锁按读者表核对调用者；读者表满时进来的读者没有登记，
+ * 这时只要还有未登记的读锁就算成功，无法核对是不是调用者自己加的
+ */
+int32_t xRWLockReadUnlock(RWLockHandle_t xRWLock);
+int32_t xRWLockWriteUnlock(RWLockHandle_t xRWLock);
+
+#endif
\ No newline at end of file
@@ -38,6 +38,17 @@ SemaphoreHandle_t xSemaphoreCreateCounting(uint32_t uxMaxCount,
 #define xSemaphoreGive(xSem) \
     xQueueSend((xSem), NULL, 0)
 
+/* 在中断中释放/获取（不阻塞），用法同 xQueueSendFromISR */
+#define xSemaphoreGiveFromISR(xSem, pxHigherPriorityTaskWoken) \
+    xQueueSendFromISR((xSem), NULL, (pxHigherPriorityTaskWoken))
+
+#define xSemaphoreTakeFromISR(xSem, pxHigherPriorityTaskWoken) \
+    xQueueReceiveFromISR((xSem), NULL, (pxHigherPriorityTaskWoken))
+
+/* 删除信号量，等待的任务 Take 返回失败 */
+#define vSemaphoreDelete(xSem) \
+    vQueueDelete((xSem))
+
 /* 查询当前计数值 */
 #define uxSemaphoreGetCount(xSem) \
     uxQueueMessagesWaiting((xSem))
@@ -0,0 +1,614 @@
+#include "stream_buffer.h"
+#include "heap.h"
+#include <string.h>
+#include <stm32f4xx.h>
+
+/*---------------------------------------------------------------------------
+ *  可读/可写字节数（内部函数）
+ *
+ *  xHead == xTail 表示空，环形缓冲区空出一个字节，所以满的时候 xHead 在 xTail 前一格
+ *---------------------------------------------------------------------------*/
+static uint32_t prvBytesInBuffer(const StreamBuffer_t *pxStreamBuffer)
+{
+    uint32_t xCount;
+
+    xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead - pxStreamBuffer->xTail;
+    if (xCount >= pxStreamBuffer->xLength)
+    {
+        xCount -= pxStreamBuffer->xLength;
+    }
+
+    return xCount;
+}
+
+static uint32_t prvSpacesInBuffer(const StreamBuffer_t *pxStreamBuffer)
+{
+    return pxStreamBuffer->xLength - 1 - prvBytesInBuffer(pxStreamBuffer);
+}
+
+/*---------------------------------------------------------------------------
+ *  从 xHead 开始写入字节（内部函数，只有写者调用）
+ *
+ *  最多分两段拷贝，返回新的写位置但不发布，
+ *  调用者把整条数据写完后再用 prvPublishHead 一次发布，读者不会看到写了一半的数据
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWriteBytesToBuffer(StreamBuffer_t *pxStreamBuffer,
+                                      const uint8_t *pucData,
+                                      uint32_t xCount,
+                                      uint32_t xHead)
+{
+    uint32_t xFirstLength;
+
+    /* 第一段：写到缓冲区末尾 */
+    xFirstLength = pxStreamBuffer->xLength - xHead;
+    if (xFirstLength > xCount)
+    {
+        xFirstLength = xCount;
+    }
+    memcpy(&(pxStreamBuffer->pucBuffer[xHead]), pucData, xFirstLength);
+
+    /* 第二段：绕回开头 */
+    if (xCount > xFirstLength)
+    {
+        memcpy(pxStreamBuffer->pucBuffer, pucData + xFirstLength, xCount - xFirstLength);
+    }
+
+    xHead += xCount;
+    if (xHead >= pxStreamBuffer->xLength)
+    {
+        xHead -= pxStreamBuffer->xLength;
+    }
+
+    return xHead;
+}
+
+static void prvPublishHead(StreamBuffer_t *pxStreamBuffer, uint32_t xHead)
+{
+    /* 数据先落到内存，再发布新的写位置 */
+    __DMB();
+    pxStreamBuffer->xHead = xHead;
+}
+
+/*---------------------------------------------------------------------------
+ *  从 xTail 开始读出字节（内部函数，只有读者调用），规则同上
+ *---------------------------------------------------------------------------*/
+static uint32_t prvReadBytesFromBuffer(StreamBuffer_t *pxStreamBuffer,
+                                       uint8_t *pucData,
+                                       uint32_t xCount,
+                                       uint32_t xTail)
+{
+    uint32_t xFirstLength;
+
+    xFirstLength = pxStreamBuffer->xLength - xTail;
+    if (xFirstLength > xCount)
+    {
+        xFirstLength = xCount;
+    }
+    memcpy(pucData, &(pxStreamBuffer->pucBuffer[xTail]), xFirstLength);
+
+    if (xCount > xFirstLength)
+    {
+        memcpy(pucData + xFirstLength, pxStreamBuffer->pucBuffer, xCount - xFirstLength);
+    }
+
+    xTail += xCount;
+    if (xTail >= pxStreamBuffer->xLength)
+    {
+        xTail -= pxStreamBuffer->xLength;
+    }
+
+    return xTail;
+}
+
+static void prvPublishTail(StreamBuffer_t *pxStreamBuffer, uint32_t xTail)
+{
+    /* 数据先读完，再释放空间给写者 */
+    __DMB();
+    pxStreamBuffer->xTail = xTail;
+}
+
+/*---------------------------------------------------------------------------
+ *  写入一次数据（内部函数，只有写者调用）
+ *
+ *  流缓冲区：能放多少写多少；
+ *  消息缓冲区：先写 2 字节长度再写内容，整条放不下就一个字节都不写
+ *  返回写入的有效字节数（不含长度头）
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWriteMessage(StreamBuffer_t *pxStreamBuffer,
+                                const uint8_t *pucData,
+                                uint32_t xDataLengthBytes,
+                                uint32_t xSpace)
+{
+    uint32_t xHead = pxStreamBuffer->xHead;
+    sbMESSAGE_LENGTH_TYPE xHeader;
+
+    if ((pxStreamBuffer->uxFlags & sbFLAGS_IS_MESSAGE_BUFFER) != 0)
+    {
+        if (xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH > xSpace)
+            return 0;
+
+        xHeader = (sbMESSAGE_LENGTH_TYPE)xDataLengthBytes;
+        xHead = prvWriteBytesToBuffer(pxStreamBuffer, (const uint8_t *)&xHeader,
+                                      sbBYTES_TO_STORE_MESSAGE_LENGTH, xHead);
+    }
+    else if (xDataLengthBytes > xSpace)
+    {
+        xDataLengthBytes = xSpace;
+    }
+
+    if (xDataLengthBytes > 0)
+    {
+        xHead = prvWriteBytesToBuffer(pxStreamBuffer, pucData, xDataLengthBytes, xHead);
+    }
+
+    /* 长度头和内容一起发布 */
+    prvPublishHead(pxStreamBuffer, xHead);
+
+    return xDataLengthBytes;
+}
+
+/*---------------------------------------------------------------------------
+ *  读出一次数据（内部函数，只有读者调用）
+ *
+ *  流缓冲区：有多少读多少；
+ *  消息缓冲区：一次读一整条，接收缓冲区放不下就留在缓冲区里返回 0
+ *---------------------------------------------------------------------------*/
+static uint32_t prvReadMessage(StreamBuffer_t *pxStreamBuffer,
+                               uint8_t *pucData,
+                               uint32_t xBufferLengthBytes,
+                               uint32_t xAvailable)
+{
+    uint32_t xTail = pxStreamBuffer->xTail;
+    sbMESSAGE_LENGTH_TYPE xHeader;
+
+    if ((pxStreamBuffer->uxFlags & sbFLAGS_IS_MESSAGE_BUFFER) != 0)
+    {
+        /* 写者整条发布，有数据就一定有完整的长度头和内容 */
+        if (xAvailable < sbBYTES_TO_STORE_MESSAGE_LENGTH)
+            return 0;
+
+        xTail = prvReadBytesFromBuffer(pxStreamBuffer, (uint8_t *)&xHeader,
+                                       sbBYTES_TO_STORE_MESSAGE_LENGTH, xTail);
+
+        if ((uint32_t)xHeader > xBufferLengthBytes)
+            return 0;
+
+        xBufferLengthBytes = (uint32_t)xHeader;
+    }
+    else if (xBufferLengthBytes > xAvailable)
+    {
+        xBufferLengthBytes = xAvailable;
+    }
+
+    if (xBufferLengthBytes > 0)
+    {
+        xTail = prvReadBytesFromBuffer(pxStreamBuffer, pucData, xBufferLengthBytes, xTail);
+    }
+
+    prvPublishTail(pxStreamBuffer, xTail);
+
+    return xBufferLengthBytes;
+}
+
+/*---------------------------------------------------------------------------
+ *  通知阻塞的对方（内部函数，必须在临界区内调用）
+ *
+ *  xFromISR 为 1 时走中断版本，不直接触发切换；
+ *  调用者不关心是否唤醒了高优先级任务（传 NULL）时用局部变量接住
+ *---------------------------------------------------------------------------*/
+static void prvNotifyWaitingTask(volatile TaskHandle_t *pxWaitingTask,
+                                 uint32_t xFromISR,
+                                 uint32_t *pxHigherPriorityTaskWoken)
+{
+    uint32_t xDummyWoken = 0;
+
+    if (*pxWaitingTask != NULL)
+    {
+        if (xFromISR)
+        {
+            if (pxHigherPriorityTaskWoken == NULL)
+            {
+                pxHigherPriorityTaskWoken = &xDummyWoken;
+            }
+            xTaskNotifyFromISR(*pxWaitingTask, 0, eNoAction, pxHigherPriorityTaskWoken);
+        }
+        else
+        {
+            xTaskNotify(*pxWaitingTask, 0, eNoAction);
+        }
+        *pxWaitingTask = NULL;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  阻塞返回后撤销登记（内部函数）
+ *
+ *  返回 1 表示等待期间缓冲区被删除，调用者直接返回 0，不能再访问缓冲区；
+ *  最后一个离开的任务负责释放内存
+ *---------------------------------------------------------------------------*/
+static uint32_t prvWaitFinished(StreamBuffer_t *pxStreamBuffer,
+                                volatile TaskHandle_t *pxWaitingTask)
+{
+    uint32_t xDeleted;
+    uint32_t xFreeNow;
+
+    taskENTER_CRITICAL();
+
+    *pxWaitingTask = NULL;
+    pxStreamBuffer->uxWaitingTasks--;
+    pxCurrentTCB->pxWaitingOnStreamBuffer = NULL;
+    xDeleted = ((pxStreamBuffer->uxFlags & sbFLAGS_IS_DELETED) != 0);
+    xFreeNow = (xDeleted != 0 && pxStreamBuffer->uxWaitingTasks == 0);
+
+    taskEXIT_CRITICAL();
+
+    if (xFreeNow)
+    {
+        vPortFree(pxStreamBuffer);
+    }
+
+    return xDeleted;
+}
+
+/*---------------------------------------------------------------------------
+ *  任务在阻塞流程里被删除时替它撤销登记（供 task.c 使用，必须在临界区内调用）
+ *
+ *  清掉指向它的等待者句柄，否则下次收发会通知已释放的 TCB；
+ *  缓冲区已经删了、它又是最后一个等待者，就由这里释放
+ *---------------------------------------------------------------------------*/
+void prvStreamBufferWaitAbandoned(TCB_t *pxTCB)
+{
+    StreamBuffer_t *pxStreamBuffer = pxTCB->pxWaitingOnStreamBuffer;
+
+    pxTCB->pxWaitingOnStreamBuffer = NULL;
+
+    if (pxStreamBuffer->xTaskWaitingToSend == pxTCB)
+    {
+        pxStreamBuffer->xTaskWaitingToSend = NULL;
+    }
+
+    if (pxStreamBuffer->xTaskWaitingToReceive == pxTCB)
+    {
+        pxStreamBuffer->xTaskWaitingToReceive = NULL;
+    }
+
+    pxStreamBuffer->uxWaitingTasks--;
+
+    if ((pxStreamBuffer->uxFlags & sbFLAGS_IS_DELETED) != 0 && pxStreamBuffer->uxWaitingTasks == 0)
+    {
+        vPortFree(pxStreamBuffer);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  创建流缓冲区/消息缓冲区
+ *---------------------------------------------------------------------------*/
+StreamBufferHandle_t xStreamBufferGenericCreate(uint32_t xBufferSizeBytes,
+                                                uint32_t xTriggerLevelBytes,
+                                                uint32_t xIsMessageBuffer)
+{
+    StreamBuffer_t *pxStreamBuffer;
+
+    if (xBufferSizeBytes == 0 || xTriggerLevelBytes > xBufferSizeBytes)
+        return NULL;
+
+    /* 消息缓冲区至少要放得下一个长度头 */
+    if (xIsMessageBuffer != 0 && xBufferSizeBytes <= sbBYTES_TO_STORE_MESSAGE_LENGTH)
+        return NULL;
+
+    if (xTriggerLevelBytes == 0)
+    {
+        xTriggerLevelBytes = 1;
+    }
+
+    /* 多分配一个字节，用来区分满和空 */
+    xBufferSizeBytes++;
+
+    pxStreamBuffer = (StreamBuffer_t *)pvPortMalloc(sizeof(StreamBuffer_t) + xBufferSizeBytes);
+    if (pxStreamBuffer == NULL)
+        return NULL;
+
+    pxStreamBuffer->xTail = 0;
+    pxStreamBuffer->xHead = 0;
+    pxStreamBuffer->xLength = xBufferSizeBytes;
+    pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+    pxStreamBuffer->xTaskWaitingToReceive = NULL;
+    pxStreamBuffer->xTaskWaitingToSend = NULL;
+    pxStreamBuffer->uxWaitingTasks = 0;
+    pxStreamBuffer->uxFlags = (xIsMessageBuffer != 0) ? sbFLAGS_IS_MESSAGE_BUFFER : 0;
+    pxStreamBuffer->pucBuffer = (uint8_t *)(pxStreamBuffer + 1);
+
+    return pxStreamBuffer;
+}
+
+/*---------------------------------------------------------------------------
+ *  删除流缓冲区/消息缓冲区
+ *
+ *  通知阻塞的读者和写者，它们醒来后返回 0；
+ *  没有任务还在阻塞流程里就直接释放，否则由最后一个离开的任务释放
+ *---------------------------------------------------------------------------*/
+void vStreamBufferDelete(StreamBufferHandle_t xStreamBuffer)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    uint32_t xFreeNow;
+
+    taskENTER_CRITICAL();
+
+    prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToReceive), 0, NULL);
+    prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToSend), 0, NULL);
+
+    /* 被通知（或者刚被正常唤醒）还没运行的任务醒来后还要访问缓冲区 */
+    pxStreamBuffer->uxFlags |= sbFLAGS_IS_DELETED;
+    xFreeNow = (pxStreamBuffer->uxWaitingTasks == 0);
+
+    taskEXIT_CRITICAL();
+
+    if (xFreeNow)
+    {
+        vPortFree(pxStreamBuffer);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  一次写入需要的空间（内部函数）
+ *
+ *  消息缓冲区要连长度头一起放下，放不下的消息返回 0，调用者直接失败
+ *---------------------------------------------------------------------------*/
+static uint32_t prvRequiredSpace(const StreamBuffer_t *pxStreamBuffer, uint32_t xDataLengthBytes)
+{
+    if ((pxStreamBuffer->uxFlags & sbFLAGS_IS_MESSAGE_BUFFER) == 0)
+        return xDataLengthBytes;
+
+    if (xDataLengthBytes > sbMAX_MESSAGE_LENGTH ||
+        xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH > pxStreamBuffer->xLength - 1)
+        return 0;
+
+    return xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH;
+}
+
+/*---------------------------------------------------------------------------
+ *  写入（带阻塞）
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer,
+                           const void *pvTxData,
+                           uint32_t xDataLengthBytes,
+                           uint32_t xTicksToWait)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    uint32_t xRequired;
+    uint32_t xSpace;
+    TimeOut_t xTimeOut;
+
+    xRequired = prvRequiredSpace(pxStreamBuffer, xDataLengthBytes);
+    if (xRequired == 0)
+        return 0;
+
+    xSpace = prvSpacesInBuffer(pxStreamBuffer);
+
+    if (xSpace < xRequired && xTicksToWait != 0)
+    {
+        vTaskSetTimeOutState(&xTimeOut);
+
+        do
+        {
+            taskENTER_CRITICAL();
+
+            /* 进临界区后再查一次，读者可能刚读走了数据 */
+            xSpace = prvSpacesInBuffer(pxStreamBuffer);
+            if (xSpace < xRequired)
+            {
+                /* 先清掉旧通知，再登记自己，读者读走数据后会通知 */
+                vTaskNotifyStateClear(NULL);
+                pxStreamBuffer->xTaskWaitingToSend = pxCurrentTCB;
+                pxStreamBuffer->uxWaitingTasks++;
+                pxCurrentTCB->pxWaitingOnStreamBuffer = pxStreamBuffer;
+            }
+
+            taskEXIT_CRITICAL();
+
+            if (xSpace >= xRequired)
+                break;
+
+            xTaskNotifyWait(0, 0, NULL, xTicksToWait);
+
+            /* 撤销登记，等待期间缓冲区被删除就直接返回 */
+            if (prvWaitFinished(pxStreamBuffer, &(pxStreamBuffer->xTaskWaitingToSend)))
+            {
+                return 0;
+            }
+
+            xSpace = prvSpacesInBuffer(pxStreamBuffer);
+
+            /* 读者腾出的空间可能还不够（或者是别的通知），没到超时就按剩余时间继续等 */
+        } while (xSpace < xRequired && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == 0);
+    }
+
+    /* 流缓冲区空间不够只写能放下的部分，消息缓冲区整条放不下就不写 */
+    xDataLengthBytes = prvWriteMessage(pxStreamBuffer, (const uint8_t *)pvTxData,
+                                       xDataLengthBytes, xSpace);
+
+    /* 达到触发水平才唤醒读者 */
+    if (prvBytesInBuffer(pxStreamBuffer) >= pxStreamBuffer->xTriggerLevelBytes &&
+        pxStreamBuffer->xTaskWaitingToReceive != NULL)
+    {
+        taskENTER_CRITICAL();
+        prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToReceive), 0, NULL);
+        taskEXIT_CRITICAL();
+    }
+
+    return xDataLengthBytes;
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中写入（不阻塞）
+ *
+ *  写数据本身不进临界区，只有读者正在阻塞且数据达到触发水平时才调用一次内核
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer,
+                                  const void *pvTxData,
+                                  uint32_t xDataLengthBytes,
+                                  uint32_t *pxHigherPriorityTaskWoken)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    uint32_t ulSavedInterruptStatus;
+
+    if (prvRequiredSpace(pxStreamBuffer, xDataLengthBytes) == 0)
+        return 0;
+
+    xDataLengthBytes = prvWriteMessage(pxStreamBuffer, (const uint8_t *)pvTxData,
+                                       xDataLengthBytes, prvSpacesInBuffer(pxStreamBuffer));
+
+    if (pxStreamBuffer->xTaskWaitingToReceive != NULL &&
+        prvBytesInBuffer(pxStreamBuffer) >= pxStreamBuffer->xTriggerLevelBytes)
+    {
+        ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToReceive), 1, pxHigherPriorityTaskWoken);
+        taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    }
+
+    return xDataLengthBytes;
+}
+
+/*---------------------------------------------------------------------------
+ *  读取（带阻塞）
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer,
+                              void *pvRxData,
+                              uint32_t xBufferLengthBytes,
+                              uint32_t xTicksToWait)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    uint32_t xAvailable;
+    uint32_t xReceived;
+    TimeOut_t xTimeOut;
+
+    xAvailable = prvBytesInBuffer(pxStreamBuffer);
+
+    if (xAvailable == 0 && xTicksToWait != 0)
+    {
+        vTaskSetTimeOutState(&xTimeOut);
+
+        do
+        {
+            taskENTER_CRITICAL();
+
+            /* 进临界区后再查一次，写者可能刚写了数据 */
+            xAvailable = prvBytesInBuffer(pxStreamBuffer);
+            if (xAvailable == 0)
+            {
+                vTaskNotifyStateClear(NULL);
+                pxStreamBuffer->xTaskWaitingToReceive = pxCurrentTCB;
+                pxStreamBuffer->uxWaitingTasks++;
+                pxCurrentTCB->pxWaitingOnStreamBuffer = pxStreamBuffer;
+            }
+
+            taskEXIT_CRITICAL();
+
+            if (xAvailable != 0)
+                break;
+
+            /* 写者在数据达到触发水平时通知 */
+            xTaskNotifyWait(0, 0, NULL, xTicksToWait);
+
+            /* 撤销登记，等待期间缓冲区被删除就直接返回 */
+            if (prvWaitFinished(pxStreamBuffer, &(pxStreamBuffer->xTaskWaitingToReceive)))
+            {
+                return 0;
+            }
+
+            xAvailable = prvBytesInBuffer(pxStreamBuffer);
+
+            /* 被别的通知唤醒时没有数据，没到超时就按剩余时间继续等 */
+        } while (xAvailable == 0 && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == 0);
+    }
+
+    xReceived = prvReadMessage(pxStreamBuffer, (uint8_t *)pvRxData, xBufferLengthBytes, xAvailable);
+
+    /* 腾出了空间，唤醒等空间的写者 */
+    if (xReceived > 0 && pxStreamBuffer->xTaskWaitingToSend != NULL)
+    {
+        taskENTER_CRITICAL();
+        prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToSend), 0, NULL);
+        taskEXIT_CRITICAL();
+    }
+
+    return xReceived;
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中读取（不阻塞）
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferReceiveFromISR(StreamBufferHandle_t xStreamBuffer,
+                                     void *pvRxData,
+                                     uint32_t xBufferLengthBytes,
+                                     uint32_t *pxHigherPriorityTaskWoken)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    uint32_t xReceived;
+    uint32_t ulSavedInterruptStatus;
+
+    xReceived = prvReadMessage(pxStreamBuffer, (uint8_t *)pvRxData, xBufferLengthBytes,
+                               prvBytesInBuffer(pxStreamBuffer));
+
+    if (xReceived > 0 && pxStreamBuffer->xTaskWaitingToSend != NULL)
+    {
+        ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        prvNotifyWaitingTask(&(pxStreamBuffer->xTaskWaitingToSend), 1, pxHigherPriorityTaskWoken);
+        taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+    }
+
+    return xReceived;
+}
+
+/*---------------------------------------------------------------------------
+ *  查询下一条消息的长度（只用于消息缓冲区）
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferNextMessageLengthBytes(StreamBufferHandle_t xStreamBuffer)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+    sbMESSAGE_LENGTH_TYPE xHeader;
+
+    if ((pxStreamBuffer->uxFlags & sbFLAGS_IS_MESSAGE_BUFFER) == 0 ||
+        prvBytesInBuffer(pxStreamBuffer) < sbBYTES_TO_STORE_MESSAGE_LENGTH)
+        return 0;
+
+    /* 只看不取，不发布 xTail */
+    prvReadBytesFromBuffer(pxStreamBuffer, (uint8_t *)&xHeader,
+                           sbBYTES_TO_STORE_MESSAGE_LENGTH, pxStreamBuffer->xTail);
+
+    return (uint32_t)xHeader;
+}
+
+/*---------------------------------------------------------------------------
+ *  查询
+ *---------------------------------------------------------------------------*/
+uint32_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer)
+{
+    return prvBytesInBuffer((StreamBuffer_t *)xStreamBuffer);
+}
+
+uint32_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer)
+{
+    return prvSpacesInBuffer((StreamBuffer_t *)xStreamBuffer);
+}
+
+/*---------------------------------------------------------------------------
+ *  修改触发水平
+ *---------------------------------------------------------------------------*/
+int32_t xStreamBufferSetTriggerLevel(StreamBufferHandle_t xStreamBuffer, uint32_t xTriggerLevel)
+{
+    StreamBuffer_t *pxStreamBuffer = (StreamBuffer_t *)xStreamBuffer;
+
+    /* 可存字节数是 xLength - 1；消息缓冲区有一整条消息就唤醒，不能改 */
+    if (xTriggerLevel >= pxStreamBuffer->xLength ||
+        (pxStreamBuffer->uxFlags & sbFLAGS_IS_MESSAGE_BUFFER) != 0)
+        return -1;
+
+    if (xTriggerLevel == 0)
+    {
+        xTriggerLevel = 1;
+    }
+
+    pxStreamBuffer->xTriggerLevelBytes = xTriggerLevel;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <stdint.h>
+#include "task.h"
+#include "queue.h"
+
+/* 消息缓冲区每条消息前面的长度头 */
+#define sbMESSAGE_LENGTH_TYPE           uint16_t
+#define sbBYTES_TO_STORE_MESSAGE_LENGTH sizeof(sbMESSAGE_LENGTH_TYPE)
+#define sbMAX_MESSAGE_LENGTH            0xFFFF
+
+/* uxFlags */
+#define sbFLAGS_IS_MESSAGE_BUFFER 0x01
+#define sbFLAGS_IS_DELETED        0x02 /* 已删除，等最后一个阻塞的任务离开后释放 */
+
+/*---------------------------------------------------------------------------
+ *  流缓冲区结构
+ *
+ *  字节环形缓冲区，单写者单读者：
+ *  xHead 只有写者改，xTail 只有读者改，读写数据本身不需要临界区，
+ *  只有阻塞/唤醒对方时才进临界区。阻塞和唤醒用任务通知实现。
+ *  消息缓冲区（message_buffer.h）用同一个结构，只是每条消息前面多一个长度头
+ *---------------------------------------------------------------------------*/
+typedef struct StreamBufferDefinition
+{
+    volatile uint32_t xTail;                     /* 下一个读的位置（只有读者改） */
+    volatile uint32_t xHead;                     /* 下一个写的位置（只有写者改） */
+    uint32_t xLength;                            /* 环形缓冲区字节数，空出一个字节区分满和空 */
+    uint32_t xTriggerLevelBytes;                 /* 至少有这么多字节才唤醒阻塞的读者 */
+    volatile TaskHandle_t xTaskWaitingToReceive; /* 阻塞等数据的读者 */
+    volatile TaskHandle_t xTaskWaitingToSend;    /* 阻塞等空间的写者 */
+    uint32_t uxWaitingTasks;                     /* 还在阻塞流程里的任务数（删除时决定谁来释放） */
+    uint32_t uxFlags;                            /* sbFLAGS_xxx */
+    uint8_t *pucBuffer;                          /* 缓冲区（紧跟在结构体后面） */
+} StreamBuffer_t;
+
+typedef StreamBuffer_t *StreamBufferHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建流缓冲区（控制块和缓冲区一次从堆上分配）
+ *   xBufferSizeBytes   : 最多能存多少字节
+ *   xTriggerLevelBytes : 触发水平，数据达到这么多字节才唤醒阻塞的读者（0 按 1 处理）
+ *   返回               : 句柄，失败返回 NULL
+ */
+#define xStreamBufferCreate(xBufferSizeBytes, xTriggerLevelBytes) \
+    xStreamBufferGenericCreate((xBufferSizeBytes), (xTriggerLevelBytes), 0)
+
+/* 流缓冲区和消息缓冲区共用的创建函数，xIsMessageBuffer 为 1 时创建消息缓冲区 */
+StreamBufferHandle_t xStreamBufferGenericCreate(uint32_t xBufferSizeBytes,
+                                                uint32_t xTriggerLevelBytes,
+                                                uint32_t xIsMessageBuffer);
+
+/*
+ * 删除流缓冲区
+ *   正在阻塞读/写的任务会被通知醒来，返回 0；
+ *   没有任务在阻塞就直接释放，否则由最后一个醒来的任务释放。
+ *   删除之后读写双方（包括中断）都不能再发起新的调用
+ */
+void vStreamBufferDelete(StreamBufferHandle_t xStreamBuffer);
+
+/*
+ * 写入字节流
+ *   xTicksToWait : 空间不够全部写下时最多等多少 tick
+ *   返回         : 实际写入的字节数（空间不够时只写能放下的部分）
+ */
+uint32_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer,
+                           const void *pvTxData,
+                           uint32_t xDataLengthBytes,
+                           uint32_t xTicksToWait);
+
+/*
+ * 在中断中写入（不阻塞），用法同 xQueueSendFromISR
+ */
+uint32_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer,
+                                  const void *pvTxData,
+                                  uint32_t xDataLengthBytes,
+                                  uint32_t *pxHigherPriorityTaskWoken);
+
+/*
+ * 读取字节流
+ *   xBufferLengthBytes : 最多读多少字节
+ *   xTicksToWait       : 缓冲区空时最多等多少 tick，
+ *                        被唤醒的条件是数据达到触发水平（或写者写不下要等空间）
+ *   返回               : 实际读到的字节数，超时返回 0
+ */
+uint32_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer,
+                              void *pvRxData,
+                              uint32_t xBufferLengthBytes,
+                              uint32_t xTicksToWait);
+
+/*
+ * 在中断中读取（不阻塞）
+ */
+uint32_t xStreamBufferReceiveFromISR(StreamBufferHandle_t xStreamBuffer,
+                                     void *pvRxData,
+                                     uint32_t xBufferLengthBytes,
+                                     uint32_t *pxHigherPriorityTaskWoken);
+
+/*
+ * 查询可读字节数 / 可写字节数
+ */
+uint32_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer);
+uint32_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer);
+
+/*
+ * 修改触发水平
+ *   返回 : 0 成功，-1 超过缓冲区大小或是消息缓冲区
+ */
+int32_t xStreamBufferSetTriggerLevel(StreamBufferHandle_t xStreamBuffer, uint32_t xTriggerLevel);
+
+/*
+ * 查询下一条消息的长度（只用于消息缓冲区）
+ *   返回 : 下一条消息的字节数，没有消息返回 0
+ */
+uint32_t xStreamBufferNextMessageLengthBytes(StreamBufferHandle_t xStreamBuffer);
+
+/* 供 task.c 使用：删除还在阻塞流程里的任务时撤销它的等待登记 */
+void prvStreamBufferWaitAbandoned(TCB_t *pxTCB);
+
+#endif
\ No newline at end of file
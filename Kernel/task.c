@@ -11,6 +11,11 @@
 #include <stdio.h>
 #include <stm32f4xx.h>
 #include "heap.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#if configUSE_TIMERS
+#include "timers.h"
+#endif
 
 /*---------------------------------------------------------------------------
  *  全局变量
@@ -18,6 +23,9 @@
 /*当前正在运行任务的句柄*/
 TCB_t *volatile pxCurrentTCB = NULL;
 
+/* 给 portasm.s 用的 BASEPRI 屏蔽值（汇编里不能直接用 C 的宏） */
+const uint32_t ulMaxSyscallInterruptPriority = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
 /* 空闲任务的栈和 TCB */
 static uint32_t xIdleTaskStack[128];
 static TCB_t xIdleTaskTCB;
@@ -28,9 +36,41 @@ volatile uint32_t xTickCount = 0;
 /* 临界区嵌套计数 */
 static volatile uint32_t uxCriticalNesting = 0;
 
-/*就绪链表数组和优先级位图*/
-List_t pxReadyTasksLists[MAX_PRIORITIES]; /* 就绪链表数组：每个优先级一条链表 */
-static uint32_t uxTopReadyPriority = 0;   /* 优先级位图：bit N = 1 表示优先级 N 有任务就绪 */
+/*
+ * 就绪链表数组和两级优先级位图
+ * 优先级 P 属于第 P/32 组：组位图 bit G = 1 表示第 G 组里有优先级就绪，
+ * 组内位图 bit N = 1 表示优先级 G*32+N 有任务就绪，两次 __CLZ 找到最高优先级。
+ * 数组都按 MAX_PRIORITIES 分配，不用的优先级不占内存。
+ */
+#if MAX_PRIORITIES > 1024
+#error "MAX_PRIORITIES 最大 1024（32 组 x 32 级）"
+#endif
+#define taskREADY_GROUPS ((MAX_PRIORITIES + 31UL) / 32UL)
+
+List_t pxReadyTasksLists[MAX_PRIORITIES];                   /* 就绪链表数组：每个优先级一条链表 */
+static uint32_t uxTopReadyGroup = 0;                        /* 一级位图：bit G = 1 表示第 G 组有任务就绪 */
+static uint32_t uxTopReadyPriority[taskREADY_GROUPS] = {0}; /* 二级位图：每组 32 个优先级 */
+
+/* 事件等待链表按 xItemValue 升序排列，优先级取反后高优先级排在前面 */
+#define taskEVENT_LIST_ITEM_VALUE(uxPriority) ((uint32_t)(MAX_PRIORITIES - 1) - (uxPriority))
+
+/* 在位图中标记/清除某个优先级 */
+#define taskRECORD_READY_PRIORITY(uxPriority)                                    \
+    do                                                                           \
+    {                                                                            \
+        uxTopReadyPriority[(uxPriority) >> 5] |= (1UL << ((uxPriority) & 31UL)); \
+        uxTopReadyGroup |= (1UL << ((uxPriority) >> 5));                         \
+    } while (0)
+
+#define taskRESET_READY_PRIORITY(uxPriority)                                      \
+    do                                                                            \
+    {                                                                             \
+        uxTopReadyPriority[(uxPriority) >> 5] &= ~(1UL << ((uxPriority) & 31UL)); \
+        if (uxTopReadyPriority[(uxPriority) >> 5] == 0)                           \
+        {                                                                         \
+            uxTopReadyGroup &= ~(1UL << ((uxPriority) >> 5));                     \
+        }                                                                         \
+    } while (0)
 
 /* 挂起链表 */
 static List_t xSuspendedTaskList;
@@ -38,12 +78,28 @@ static List_t xSuspendedTaskList;
 /* 删除等待链表（等空闲任务来回收） */
 static List_t xTasksWaitingTermination;
 
-/*延时链表，使用两个链表，应对xNextTaskUnblockTime溢出情况*/
-static List_t xDelayedTaskList1;
-static List_t xDelayedTaskList2;
-static List_t *pxDelayedTaskList;                             /* 当前延时链表 */
-static List_t *pxOverflowDelayedTaskList;                     /* 溢出延时链表 */
-static volatile uint32_t xNextTaskUnblockTime = 0xFFFFFFFFUL; /* 下一个需要唤醒的时间点（优化：不用每次遍历链表） */
+/*
+ * 延时时间轮（哈希时间轮）
+ * 唤醒时间为 T 的任务挂在第 (T & 掩码) 个槽上，槽内不排序，插入/取消都是 O(1)。
+ * 唤醒时间按 32 位取模比较（T - xTickCount），tick 溢出不需要第二条链表。
+ * 占用位图 bit = 1 表示槽里可能有任务，下一个非空槽用 __CLZ 查找，不用逐槽遍历；
+ * 任务提前离开时不清位，查找时碰到空槽再清。
+ */
+#if (configDELAY_WHEEL_SLOTS < 32) || ((configDELAY_WHEEL_SLOTS & (configDELAY_WHEEL_SLOTS - 1)) != 0)
+#error "configDELAY_WHEEL_SLOTS 必须是 2 的幂且不小于 32"
+#endif
+#define taskDELAY_WHEEL_MASK (configDELAY_WHEEL_SLOTS - 1UL)
+#define taskDELAY_WHEEL_WORDS (configDELAY_WHEEL_SLOTS / 32UL)
+static List_t xDelayedTaskWheel[configDELAY_WHEEL_SLOTS];
+static uint32_t uxDelayWheelBitmap[taskDELAY_WHEEL_WORDS] = {0}; /* 槽占用位图 */
+static volatile uint32_t xDelayedTasksPending = 0;   /* 1 = 时间轮上可能还有任务，xNextTaskUnblockTime 有效 */
+static volatile uint32_t xNextTaskUnblockTime = 0;   /* 下一个需要检查时间轮的时间点（不晚于最早唤醒时间） */
+
+#if configUSE_TICKLESS_IDLE
+/* tickless 用到的 SysTick 参数，在 prvStartSysTick 中计算 */
+static uint32_t ulTimerCountsForOneTick = 0;         /* 一个 tick 对应的 SysTick 计数值 */
+static uint32_t xMaximumPossibleSuppressedTicks = 0; /* 24 位 SysTick 一次最多能跨越的 tick 数 */
+#endif
 
 /*---------------------------------------------------------------------------
  *  内部函数声明
@@ -53,8 +109,26 @@ static uint32_t *prvInitialiseStack(uint32_t *pxTopOfStack,
                                     TaskFunction_t pxCode,
                                     void *pvParam);
 static void prvSelectHighestPriorityTask(void);
-static void prvSwitchDelayedLists(void);
+static void prvUnlinkReadyTask(TCB_t *pxTCB);
+static void prvRotateReadyList(List_t *pxList);
+static uint32_t prvTaskPreemptsCurrent(TCB_t *pxTCB);
+static int32_t prvNotify(TCB_t *pxTCB, uint32_t ulValue, eNotifyAction eAction,
+                         uint32_t *pxSwitchRequired);
+static void prvWaitForNotification(uint32_t xTicksToWait);
+void prvAddCurrentTaskToDelayedList(uint32_t xTicksToDelay);
+static TCB_t *prvAllocateNewTask(TaskFunction_t pxTaskCode,
+                                 const char *pcName,
+                                 uint32_t ulStackSize,
+                                 void *pvParam,
+                                 uint32_t uxPriority);
+static void prvResetNextTaskUnblockTime(uint32_t xConstTickCount);
+static uint32_t prvCheckDelayedTasks(uint32_t xConstTickCount);
 static void prvIdleTask(void *param);
+#if configUSE_TICKLESS_IDLE
+static uint32_t prvGetExpectedIdleTime(void);
+static void prvStepTick(uint32_t xTicksToJump);
+static void prvSuppressTicksAndSleep(void);
+#endif
 
 /*---------------------------------------------------------------------------
  *  三个汇编函数，在portasm.s中编写
@@ -70,7 +144,14 @@ static void prvTaskExitError(void)
         ;
 }
 
-/*初始化栈帧*/
+/*
+ * 初始化栈帧
+ *
+ * EXC_RETURN 和 r4-r11 一起保存在任务栈里，bit4 = 0 表示该任务用过 FPU、
+ * 硬件压的是带 s0-s15/FPSCR 的扩展帧，PendSV 再额外保存 s16-s31。
+ * 新任务还没用过 FPU，从短帧开始。
+ */
+#define portINITIAL_EXC_RETURN (0xFFFFFFFDUL)
 static uint32_t *prvInitialiseStack(uint32_t *pxTopOfStack,
                                     TaskFunction_t pxCode,
                                     void *pvParam)
@@ -105,7 +186,10 @@ static uint32_t *prvInitialiseStack(uint32_t *pxTopOfStack,
     pxTopOfStack--;
     *pxTopOfStack = (uint32_t)pvParam; /* R0: 任务参数 */
 
-    /* --- 我们手动保存/恢复的 8 个寄存器 --- */
+    /* --- 我们手动保存/恢复的 EXC_RETURN + 8 个寄存器 --- */
+    pxTopOfStack--;
+    *pxTopOfStack = portINITIAL_EXC_RETURN; /* EXC_RETURN: 线程模式 + PSP + 不带 FPU 的短帧 */
+
     pxTopOfStack--;
     *pxTopOfStack = (uint32_t)0x11111111UL; /* R11 */
 
@@ -138,7 +222,33 @@ static uint32_t *prvInitialiseStack(uint32_t *pxTopOfStack,
 void prvAddTaskToReadyList(TCB_t *pxTCB)
 {
     /* 在位图中标记该优先级有任务 */
-    uxTopReadyPriority |= (1UL << pxTCB->uxPriority);
+    taskRECORD_READY_PRIORITY(pxTCB->uxPriority);
+
+    /* 重新就绪的任务拿到完整的时间片 */
+    pxTCB->ulTimeSliceRemaining = pxTCB->ulTimeSlice;
+
+#if configUSE_EDF_SCHEDULING
+    /* EDF 优先级带：按绝对截止时间排序插入，头部就是最早截止的任务 */
+    if (pxTCB->uxPriority == configEDF_PRIORITY)
+    {
+        if (pxTCB->xRelativeDeadline == 0)
+        {
+            /* 普通任务（比如优先级继承进来的）当作立即到期，排在最前面 */
+            pxTCB->xAbsoluteDeadline = xTickCount;
+        }
+        else if (pxTCB->xEdfJobPending != 0)
+        {
+            /* 非周期任务被唤醒：新作业从现在开始 */
+            pxTCB->xAbsoluteDeadline = xTickCount + pxTCB->xRelativeDeadline;
+            pxTCB->xEdfJobPending = 0;
+        }
+
+        pxTCB->xStateListItem.xItemValue = pxTCB->xAbsoluteDeadline;
+        vListInsertWrapped(&(pxReadyTasksLists[configEDF_PRIORITY]),
+                           &(pxTCB->xStateListItem));
+        return;
+    }
+#endif
 
     /* 把任务的节点插到对应优先级的就绪链表尾部 */
     vListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]),
@@ -148,46 +258,194 @@ void prvAddTaskToReadyList(TCB_t *pxTCB)
 /*找到最高就绪优先级，从中取出任务设为 pxCurrentTCB*/
 static void prvSelectHighestPriorityTask(void)
 {
+    uint32_t uxTopGroup;
     uint32_t uxTopPriority;
     List_t *pxList;
 
-    /* 位图找最高优先级 */
-    uxTopPriority = (31UL - (uint32_t)__CLZ(uxTopReadyPriority));
+    /* 两级位图找最高优先级：先找最高的组，再找组内最高位 */
+    uxTopGroup = (31UL - (uint32_t)__CLZ(uxTopReadyGroup));
+    uxTopPriority = (uxTopGroup << 5) + (31UL - (uint32_t)__CLZ(uxTopReadyPriority[uxTopGroup]));
 
     pxList = &pxReadyTasksLists[uxTopPriority];
 
-    /* 移动 pxIndex 到下一个节点（实现同优先级轮转） */
-    pxList->pxIndex = pxList->pxIndex->pxNext;
+#if configUSE_EDF_SCHEDULING
+    /* EDF 优先级带不轮转，直接取截止时间最早的链表头 */
+    if (uxTopPriority == configEDF_PRIORITY)
+    {
+        pxCurrentTCB = (TCB_t *)pxList->xListEnd.pxNext->pvOwner;
+        return;
+    }
+#endif
 
-    /* 如果 pxIndex 指向了哨兵，再跳一个 */
+    /*
+     * pxIndex 指向占用时间片的任务，选择时不移动，
+     * 被高优先级抢占的任务回来后接着用剩下的时间片；
+     * 只有时间片用完或主动让出时才轮转（prvRotateReadyList）
+     */
     if ((void *)pxList->pxIndex == (void *)&(pxList->xListEnd))
     {
+        /* 指向哨兵（刚初始化或上一个任务离开后轮到末尾），取第一个 */
         pxList->pxIndex = pxList->pxIndex->pxNext;
     }
 
     pxCurrentTCB = (TCB_t *)pxList->pxIndex->pvOwner;
 }
 
-/*交换延时链表（tick 溢出时调用）*/
-static void prvSwitchDelayedLists(void)
+/*判断刚就绪的任务是否应该抢占当前任务*/
+static uint32_t prvTaskPreemptsCurrent(TCB_t *pxTCB)
 {
-    List_t *pxTemp;
+    if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+    {
+        return 1;
+    }
 
-    /* 交换两个链表指针 */
-    pxTemp = pxDelayedTaskList;
-    pxDelayedTaskList = pxOverflowDelayedTaskList;
-    pxOverflowDelayedTaskList = pxTemp;
+#if configUSE_EDF_SCHEDULING
+    /* 同在 EDF 带内，截止时间更早的抢占 */
+    if (pxTCB->uxPriority == configEDF_PRIORITY &&
+        pxCurrentTCB->uxPriority == configEDF_PRIORITY &&
+        (int32_t)(pxTCB->xAbsoluteDeadline - pxCurrentTCB->xAbsoluteDeadline) < 0)
+    {
+        return 1;
+    }
+#endif
 
-    /* 更新最近唤醒时间 */
-    if (pxDelayedTaskList->uxNumberOfItems > 0)
+    return 0;
+}
+
+/*同优先级轮转：把时间片交给链表中的下一个任务*/
+static void prvRotateReadyList(List_t *pxList)
+{
+    pxList->pxIndex = pxList->pxIndex->pxNext;
+
+    /* 如果 pxIndex 指向了哨兵，再跳一个 */
+    if ((void *)pxList->pxIndex == (void *)&(pxList->xListEnd))
     {
-        ListItem_t *pxHead = pxDelayedTaskList->xListEnd.pxNext;
-        xNextTaskUnblockTime = pxHead->xItemValue; /*更新为头节点的value值*/
+        pxList->pxIndex = pxList->pxIndex->pxNext;
     }
-    else
+}
+
+/*重新计算下一个唤醒时间（时间轮到期处理后调用），
+  从下一个 tick 的槽开始按位图找第一个非空槽，只和位图字数有关，与任务数无关；
+  得到的是下界：那个槽里也可能只有以后几圈的任务，到时检查一下不唤醒即可*/
+static void prvResetNextTaskUnblockTime(uint32_t xConstTickCount)
+{
+    const uint32_t uxStart = (xConstTickCount + 1UL) & taskDELAY_WHEEL_MASK;
+    uint32_t uxWord;
+    uint32_t uxBits;
+    uint32_t uxSlot;
+    uint32_t k;
+
+    for (;;)
+    {
+        uxSlot = configDELAY_WHEEL_SLOTS;
+
+        /* 从起始槽所在的字开始绕一圈，最后回到起始字的低位部分 */
+        for (k = 0; k <= taskDELAY_WHEEL_WORDS; k++)
+        {
+            uxWord = ((uxStart >> 5) + k) % taskDELAY_WHEEL_WORDS;
+            uxBits = uxDelayWheelBitmap[uxWord];
+
+            if (k == 0)
+            {
+                uxBits &= (0xFFFFFFFFUL << (uxStart & 31UL));
+            }
+            else if (k == taskDELAY_WHEEL_WORDS)
+            {
+                uxBits &= ~(0xFFFFFFFFUL << (uxStart & 31UL));
+            }
+
+            if (uxBits != 0)
+            {
+                /* 取最低的置位 bit */
+                uxSlot = (uxWord << 5) + (31UL - (uint32_t)__CLZ(uxBits & (0UL - uxBits)));
+                break;
+            }
+        }
+
+        if (uxSlot == configDELAY_WHEEL_SLOTS)
+        {
+            /* 时间轮空了 */
+            xDelayedTasksPending = 0;
+            return;
+        }
+
+        if (xDelayedTaskWheel[uxSlot].uxNumberOfItems == 0)
+        {
+            /* 任务已经提前离开，清掉这一位接着找 */
+            uxDelayWheelBitmap[uxSlot >> 5] &= ~(1UL << (uxSlot & 31UL));
+            continue;
+        }
+
+        xNextTaskUnblockTime = xConstTickCount + 1UL + ((uxSlot - uxStart) & taskDELAY_WHEEL_MASK);
+        xDelayedTasksPending = 1;
+        return;
+    }
+}
+
+/*唤醒时间轮上已经到期的任务，必须在临界区内调用，返回 1 表示需要切换,
+  从 xNextTaskUnblockTime 到 xConstTickCount 的槽逐个检查（取模比较，溢出也成立）：
+  正常每个 tick 只有一个槽，tickless 补 tick 后一次可能跨过好几个，最多检查一圈*/
+static uint32_t prvCheckDelayedTasks(uint32_t xConstTickCount)
+{
+    TCB_t *pxTCB;
+    List_t *pxSlot;
+    ListItem_t *pxItem;
+    ListItem_t *pxNext;
+    uint32_t xSlotsToCheck;
+    uint32_t xTime;
+    uint32_t xSwitchRequired = 0;
+
+    if (xDelayedTasksPending == 0 || (int32_t)(xConstTickCount - xNextTaskUnblockTime) < 0)
+    {
+        return 0;
+    }
+
+    xSlotsToCheck = xConstTickCount - xNextTaskUnblockTime + 1UL;
+    if (xSlotsToCheck > configDELAY_WHEEL_SLOTS)
     {
-        xNextTaskUnblockTime = 0xFFFFFFFFUL;
+        xSlotsToCheck = configDELAY_WHEEL_SLOTS;
     }
+
+    for (xTime = xConstTickCount - xSlotsToCheck + 1UL; xSlotsToCheck > 0; xSlotsToCheck--, xTime++)
+    {
+        pxSlot = &xDelayedTaskWheel[xTime & taskDELAY_WHEEL_MASK];
+        pxItem = pxSlot->xListEnd.pxNext;
+
+        while ((void *)pxItem != (void *)&(pxSlot->xListEnd))
+        {
+            pxNext = pxItem->pxNext;
+
+            /* 同一个槽里还有以后几圈才到期的任务，只唤醒已经到期的 */
+            if ((int32_t)(pxItem->xItemValue - xConstTickCount) <= 0)
+            {
+                /* 到时间了！从时间轮移除 */
+                pxTCB = (TCB_t *)pxItem->pvOwner;
+                uxListRemove(pxItem);
+
+                /* 如果任务还在队列等待链表上，也移除 */
+                if (pxTCB->xEventListItem.pvContainer != NULL)
+                {
+                    uxListRemove(&(pxTCB->xEventListItem));
+                }
+
+                /* 放回就绪链表 */
+                prvAddTaskToReadyList(pxTCB);
+
+                /* 唤醒的任务比当前任务更该运行，才需要切换 */
+                if (prvTaskPreemptsCurrent(pxTCB))
+                {
+                    xSwitchRequired = 1;
+                }
+            }
+
+            pxItem = pxNext;
+        }
+    }
+
+    /* 找下一个唤醒时间 */
+    prvResetNextTaskUnblockTime(xConstTickCount);
+
+    return xSwitchRequired;
 }
 
 /*空闲任务函数,标记后在空闲任务里面回收堆*/
@@ -221,8 +479,53 @@ static void prvIdleTask(void *param)
                 break;
             }
         }
+
+#if configUSE_TICKLESS_IDLE
+        /* 只剩空闲任务就绪，且离下一个唤醒点足够远，停掉节拍去睡觉 */
+        if (prvGetExpectedIdleTime() >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP)
+        {
+            prvSuppressTicksAndSleep();
+        }
+#endif
+    }
+}
+
+#if configUSE_TICKLESS_IDLE
+/*计算还能空闲多少个 tick，除空闲任务外还有任务就绪时返回 0*/
+static uint32_t prvGetExpectedIdleTime(void)
+{
+    /* 位图里只有优先级 0，且优先级 0 链表里只有空闲任务自己 */
+    if (uxTopReadyGroup != 1UL || uxTopReadyPriority[0] != 1UL ||
+        pxReadyTasksLists[0].uxNumberOfItems > 1)
+    {
+        return 0;
+    }
+
+    /* 没有延时任务，返回最大值，由调用者截断 */
+    if (xDelayedTasksPending == 0)
+    {
+        return 0xFFFFFFFFUL;
+    }
+
+    return xNextTaskUnblockTime - xTickCount;
+}
+
+/*睡醒后补上被跳过的 tick，关中断时调用*/
+static void prvStepTick(uint32_t xTicksToJump)
+{
+    /*
+     * 睡眠时长不会超过 xNextTaskUnblockTime，补完后 xTickCount 最多正好等于它。
+     * 定时到点时 SysTick_Handler 只把 tick 加了 1（那时还没到唤醒点），
+     * 唤醒点这个 tick 是在这里补上的，必须在这里处理到期任务，不能等下一个 tick
+     */
+    xTickCount += xTicksToJump;
+
+    if (prvCheckDelayedTasks(xTickCount))
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
     }
 }
+#endif
 
 /*创建空闲任务，调度器启动时调用*/
 static void prvCreateIdleTask(void)
@@ -234,6 +537,8 @@ static void prvCreateIdleTask(void)
         prvIdleTask,
         NULL);
     xIdleTaskTCB.uxPriority = 0; /* 最低优先级 */
+    xIdleTaskTCB.ulSchedPolicy = taskSCHED_RR;
+    xIdleTaskTCB.ulTimeSlice = configTIME_SLICE_TICKS;
 
     strncpy(xIdleTaskTCB.pcTaskName, "IDLE", TASK_NAME_LEN - 1);
     xIdleTaskTCB.pcTaskName[TASK_NAME_LEN - 1] = '\0';
@@ -247,13 +552,12 @@ static void prvCreateIdleTask(void)
     prvAddTaskToReadyList(&xIdleTaskTCB);
 }
 
-/*创建任务*/
-int32_t xTaskCreate(TaskFunction_t pxTaskCode,
-                    const char *pcName,
-                    uint32_t ulStackSize,
-                    void *pvParam,
-                    uint32_t uxPriority,
-                    TaskHandle_t *pxHandle)
+/*分配并初始化新任务的栈和 TCB（不加入就绪链表）*/
+static TCB_t *prvAllocateNewTask(TaskFunction_t pxTaskCode,
+                                 const char *pcName,
+                                 uint32_t ulStackSize,
+                                 void *pvParam,
+                                 uint32_t uxPriority)
 {
     TCB_t *pxNewTCB;   /*新tcb*/
     uint32_t *pxStack; /*栈底地址*/
@@ -288,14 +592,14 @@ int32_t xTaskCreate(TaskFunction_t pxTaskCode,
     /* 动态分配栈 */
     pxStack = (uint32_t *)pvPortMalloc(ulStackSize * sizeof(uint32_t));
     if (pxStack == NULL)
-        return -1;
+        return NULL;
 
     /* 动态分配 TCB */
     pxNewTCB = (TCB_t *)pvPortMalloc(sizeof(TCB_t));
     if (pxNewTCB == NULL)
     {
         vPortFree(pxStack);
-        return -1;
+        return NULL;
     }
 
     /* 2. 记录栈信息 */
@@ -310,6 +614,19 @@ int32_t xTaskCreate(TaskFunction_t pxTaskCode,
         uxPriority = MAX_PRIORITIES - 1;
     pxNewTCB->uxPriority = uxPriority;
 
+    /* 默认同优先级轮转，时间片 configTIME_SLICE_TICKS */
+    pxNewTCB->ulSchedPolicy = taskSCHED_RR;
+    pxNewTCB->ulTimeSlice = configTIME_SLICE_TICKS;
+    pxNewTCB->ulTimeSliceRemaining = configTIME_SLICE_TICKS;
+
+    /* 任务通知初始为空 */
+    pxNewTCB->ulNotifiedValue = 0;
+    pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+    pxNewTCB->ulEventWaitBits = 0;
+    pxNewTCB->pxWaitingOnQueue = NULL;
+    pxNewTCB->pxWaitingOnStreamBuffer = NULL;
+    pxNewTCB->ucQueuePeek = 0;
+
     /* 5. 复制任务名 */
     strncpy(pxNewTCB->pcTaskName, pcName, TASK_NAME_LEN - 1);
     pxNewTCB->pcTaskName[TASK_NAME_LEN - 1] = '\0';
@@ -320,8 +637,36 @@ int32_t xTaskCreate(TaskFunction_t pxTaskCode,
     vListInitItem(&(pxNewTCB->xEventListItem));  /*队列阻塞链表箱*/
     pxNewTCB->xEventListItem.pvOwner = pxNewTCB;
 
+#if configUSE_EDF_SCHEDULING
+    /* 默认是普通固定优先级任务 */
+    pxNewTCB->xRelativeDeadline = 0;
+    pxNewTCB->xPeriod = 0;
+    pxNewTCB->xAbsoluteDeadline = 0;
+    pxNewTCB->xNextRelease = 0;
+    pxNewTCB->xEdfJobPending = 0;
+#endif
+
+    return pxNewTCB;
+}
+
+/*创建任务*/
+int32_t xTaskCreate(TaskFunction_t pxTaskCode,
+                    const char *pcName,
+                    uint32_t ulStackSize,
+                    void *pvParam,
+                    uint32_t uxPriority,
+                    TaskHandle_t *pxHandle)
+{
+    TCB_t *pxNewTCB;
+
+    pxNewTCB = prvAllocateNewTask(pxTaskCode, pcName, ulStackSize, pvParam, uxPriority);
+    if (pxNewTCB == NULL)
+        return -1;
+
     /* 7. 加入就绪链表 */
+    taskENTER_CRITICAL();
     prvAddTaskToReadyList(pxNewTCB);
+    taskEXIT_CRITICAL();
 
     /* 8. 输出句柄 */
     if (pxHandle != NULL)
@@ -330,9 +675,105 @@ int32_t xTaskCreate(TaskFunction_t pxTaskCode,
     return 0;
 }
 
+#if configUSE_EDF_SCHEDULING
+/*
+ * 创建 EDF 任务
+ *   xRelativeDeadline : 相对截止时间（tick），每个作业释放后多久必须完成
+ *   xPeriod           : 周期（tick），0 表示非周期任务（每次从阻塞中被唤醒算一个新作业）
+ * 任务放在 configEDF_PRIORITY 优先级带内，带内总是运行截止时间最早的任务
+ */
+int32_t xTaskCreateEDF(TaskFunction_t pxTaskCode,
+                       const char *pcName,
+                       uint32_t ulStackSize,
+                       void *pvParam,
+                       uint32_t xRelativeDeadline,
+                       uint32_t xPeriod,
+                       TaskHandle_t *pxHandle)
+{
+    TCB_t *pxNewTCB;
+
+    if (xRelativeDeadline == 0)
+        return -1;
+
+    pxNewTCB = prvAllocateNewTask(pxTaskCode, pcName, ulStackSize, pvParam, configEDF_PRIORITY);
+    if (pxNewTCB == NULL)
+        return -1;
+
+    taskENTER_CRITICAL();
+
+    /* 第一个作业从现在释放 */
+    pxNewTCB->xRelativeDeadline = xRelativeDeadline;
+    pxNewTCB->xPeriod = xPeriod;
+    pxNewTCB->xNextRelease = xTickCount;
+    pxNewTCB->xAbsoluteDeadline = pxNewTCB->xNextRelease + xRelativeDeadline;
+
+    prvAddTaskToReadyList(pxNewTCB);
+
+    taskEXIT_CRITICAL();
+
+    if (pxHandle != NULL)
+        *pxHandle = pxNewTCB;
+
+    return 0;
+}
+
+/*
+ * 周期 EDF 任务结束当前作业，阻塞到下一个周期的释放时间
+ * 释放时间按周期累加（不随执行时间漂移），截止时间 = 释放时间 + 相对截止时间；
+ * 已经错过释放时间则不阻塞，按新的截止时间重新排队
+ */
+void vTaskWaitForNextPeriod(void)
+{
+    TCB_t *pxTCB = pxCurrentTCB;
+    uint32_t xTicksToRelease;
+
+    /* 只对周期 EDF 任务有效 */
+    if (pxTCB->xRelativeDeadline == 0 || pxTCB->xPeriod == 0)
+        return;
+
+    taskENTER_CRITICAL();
+
+    pxTCB->xNextRelease += pxTCB->xPeriod;
+    pxTCB->xAbsoluteDeadline = pxTCB->xNextRelease + pxTCB->xRelativeDeadline;
+    xTicksToRelease = pxTCB->xNextRelease - xTickCount;
+
+    /* 直接摘链，不算作“阻塞后新作业”，截止时间已在上面算好 */
+    prvUnlinkReadyTask(pxTCB);
+
+    if ((int32_t)xTicksToRelease > 0)
+    {
+        /* 睡到释放时间 */
+        prvAddCurrentTaskToDelayedList(xTicksToRelease);
+    }
+    else
+    {
+        /* 超期了，立即开始下一个作业 */
+        prvAddTaskToReadyList(pxTCB);
+    }
+
+    taskEXIT_CRITICAL();
+
+    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+}
+#endif
+
 /*触发pendsv，切换上下文*/
 void taskYIELD(void)
 {
+    List_t *pxList;
+
+    taskENTER_CRITICAL();
+
+    /* 主动让出：轮到同优先级的下一个任务，自己排到最后并重新拿到完整时间片 */
+    pxList = &pxReadyTasksLists[pxCurrentTCB->uxPriority];
+    if (pxList->pxIndex == &(pxCurrentTCB->xStateListItem))
+    {
+        prvRotateReadyList(pxList);
+    }
+    pxCurrentTCB->ulTimeSliceRemaining = pxCurrentTCB->ulTimeSlice;
+
+    taskEXIT_CRITICAL();
+
     /* 触发 PendSV */
     portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
 }
@@ -377,71 +818,209 @@ static void prvStartSysTick(void)
     /* 重装载值 */
     portNVIC_SYSTICK_LOAD = (SystemCoreClock / configTICK_RATE_HZ) - 1;
 
+#if configUSE_TICKLESS_IDLE
+    ulTimerCountsForOneTick = SystemCoreClock / configTICK_RATE_HZ;
+    xMaximumPossibleSuppressedTicks = 0x00FFFFFFUL / ulTimerCountsForOneTick;
+#endif
+
     /* 启动: 使用内核时钟 + 开中断 + 使能 */
     portNVIC_SYSTICK_CTRL = portNVIC_SYSTICK_CLK | portNVIC_SYSTICK_INT | portNVIC_SYSTICK_EN;
 }
 
+#if configUSE_TICKLESS_IDLE
+/*
+ * 停掉周期节拍并睡眠（空闲任务调用）
+ *
+ * 把 SysTick 重装载值改成“到 xNextTaskUnblockTime 为止”的长度，WFI 睡眠，
+ * 醒来后根据计数器剩余值算出睡了几个完整的 tick，补到 xTickCount 上，
+ * 再把 SysTick 恢复成 1 个 tick 的周期。
+ */
+#define portNVIC_SYSTICK_COUNT_FLAG (1UL << 16)     /* 计数到 0 标志，读 CTRL 后清零 */
+#define portNVIC_PENDSTSET_BIT (1UL << 26)          /* ICSR: SysTick 挂起 */
+#define portNVIC_PENDSTCLR_BIT (1UL << 25)          /* ICSR: 清除 SysTick 挂起 */
+static void prvSuppressTicksAndSleep(void)
+{
+    uint32_t xExpectedIdleTime;
+    uint32_t ulReloadValue;
+    uint32_t ulCompleteTickPeriods;
+    uint32_t ulCompletedSysTickDecrements;
+    uint32_t ulCountsLeft;
+
+    /* 关中断后重新确认（期间可能有中断让任务就绪），WFI 在关中断时也能被中断唤醒 */
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    xExpectedIdleTime = prvGetExpectedIdleTime();
+    if (xExpectedIdleTime < configEXPECTED_IDLE_TIME_BEFORE_SLEEP ||
+        (portNVIC_INT_CTRL_REG & portNVIC_PENDSVSET_BIT) != 0)
+    {
+        __enable_irq();
+        return;
+    }
+
+    /* 24 位计数器能表示的最长时间 */
+    if (xExpectedIdleTime > xMaximumPossibleSuppressedTicks)
+    {
+        xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+    }
+
+    /* 停止 SysTick，当前这个 tick 剩下的计数 + 后面完整的 tick */
+    portNVIC_SYSTICK_CTRL = portNVIC_SYSTICK_CLK | portNVIC_SYSTICK_INT;
+    ulCountsLeft = portNVIC_SYSTICK_VAL;
+    if (ulCountsLeft == 0)
+    {
+        ulCountsLeft = ulTimerCountsForOneTick;
+    }
+    ulReloadValue = ulCountsLeft + (ulTimerCountsForOneTick * (xExpectedIdleTime - 1UL));
+
+    /* 停止前刚好数到 0，tick 中断已挂起，这个 tick 由中断补上 */
+    if ((portNVIC_INT_CTRL_REG & portNVIC_PENDSTSET_BIT) != 0)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSTCLR_BIT;
+        ulReloadValue -= ulTimerCountsForOneTick;
+    }
+
+    /* 一次性定时到唤醒点 */
+    portNVIC_SYSTICK_LOAD = ulReloadValue;
+    portNVIC_SYSTICK_VAL = 0;
+    portNVIC_SYSTICK_CTRL |= portNVIC_SYSTICK_EN;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* 开一下中断，让唤醒我们的中断（可能就是 SysTick）先执行 */
+    __enable_irq();
+    __DSB();
+    __ISB();
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    /* 再次停止 SysTick，计算实际睡了多久 */
+    portNVIC_SYSTICK_CTRL = portNVIC_SYSTICK_CLK | portNVIC_SYSTICK_INT;
+
+    if ((portNVIC_SYSTICK_CTRL & portNVIC_SYSTICK_COUNT_FLAG) != 0)
+    {
+        /*
+         * 定时到点，SysTick_Handler 已经在上面开中断的窗口里执行过，但只把 xTickCount +1，
+         * 剩下的 xExpectedIdleTime - 1 个 tick（包括唤醒点）由 prvStepTick 补上并唤醒任务；
+         * 计数器此时已从 ulReloadValue 重新开始数，剩下的部分作为下一个 tick 的长度
+         */
+        uint32_t ulCalculatedLoadValue;
+
+        ulCalculatedLoadValue = (ulTimerCountsForOneTick - 1UL) - (ulReloadValue - portNVIC_SYSTICK_VAL);
+        if (ulCalculatedLoadValue > ulTimerCountsForOneTick)
+        {
+            ulCalculatedLoadValue = ulTimerCountsForOneTick - 1UL;
+        }
+        portNVIC_SYSTICK_LOAD = ulCalculatedLoadValue;
+
+        ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
+    }
+    else
+    {
+        /* 被其他中断提前唤醒：算出走过的完整 tick 数，零头留给下一个 tick */
+        ulCompletedSysTickDecrements = (xExpectedIdleTime * ulTimerCountsForOneTick) - portNVIC_SYSTICK_VAL;
+        ulCompleteTickPeriods = ulCompletedSysTickDecrements / ulTimerCountsForOneTick;
+        portNVIC_SYSTICK_LOAD = ((ulCompleteTickPeriods + 1UL) * ulTimerCountsForOneTick) - ulCompletedSysTickDecrements;
+    }
+
+    /* 重新启动 SysTick，补上跳过的 tick，下一次重装载恢复成 1 个 tick */
+    portNVIC_SYSTICK_VAL = 0;
+    portNVIC_SYSTICK_CTRL |= portNVIC_SYSTICK_EN;
+    prvStepTick(ulCompleteTickPeriods);
+    portNVIC_SYSTICK_LOAD = ulTimerCountsForOneTick - 1UL;
+
+    __enable_irq();
+}
+#endif
+
 /*SysTick 中断处理,
-  检查延时链表，唤醒到时间的任务，
-  触发pendsv切换任务*/
+  检查延时时间轮，唤醒到时间的任务，
+  只有唤醒了更该运行的任务或时间片轮转时才触发pendsv切换任务*/
 void SysTick_Handler(void)
 {
     TCB_t *pxTCB;
     uint32_t xConstTickCount;
+    uint32_t xSwitchRequired = 0;
+    uint32_t ulSavedInterruptStatus;
 
-    taskDISABLE_INTERRUPTS();
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 
     /* tick +1 */
     xTickCount++;
     xConstTickCount = xTickCount;
 
-    /* 检查是否溢出（tick 从 0xFFFFFFFF 变成 0） */
-    if (xConstTickCount == 0)
+    /* 检查时间轮，唤醒到期的任务 */
+    if (prvCheckDelayedTasks(xConstTickCount))
     {
-        prvSwitchDelayedLists(); /*交换两个延时链表的指向*/
+        xSwitchRequired = 1;
     }
 
-    /* 检查延时链表中是否有任务该醒了 */
-    if (xConstTickCount >= xNextTaskUnblockTime)
+    /* 时间片计账：只给正在运行的 RR 任务扣时间片，FIFO 任务不轮转 */
+    pxTCB = pxCurrentTCB;
+    if (pxTCB->ulSchedPolicy == taskSCHED_RR)
     {
-        while (1)
+        List_t *pxList = &pxReadyTasksLists[pxTCB->uxPriority];
+
+        if (pxTCB->ulTimeSliceRemaining > 0)
+        {
+            pxTCB->ulTimeSliceRemaining--;
+        }
+
+        if (pxTCB->ulTimeSliceRemaining == 0)
         {
-            /* 延时链表为空，没有任务在等 */
-            if (pxDelayedTaskList->uxNumberOfItems == 0)
+            pxTCB->ulTimeSliceRemaining = pxTCB->ulTimeSlice;
+
+            /* 时间片用完，有同优先级任务就轮转（EDF 带按截止时间调度，不轮转） */
+            if (pxList->uxNumberOfItems > 1 &&
+                pxList->pxIndex == &(pxTCB->xStateListItem)
+#if configUSE_EDF_SCHEDULING
+                && pxTCB->uxPriority != configEDF_PRIORITY
+#endif
+            )
             {
-                xNextTaskUnblockTime = 0xFFFFFFFFUL;
-                break;
+                prvRotateReadyList(pxList);
+                xSwitchRequired = 1;
             }
+        }
+    }
 
-            /* 看链表头部（最早该醒的任务） */
-            ListItem_t *pxHead = pxDelayedTaskList->xListEnd.pxNext;
+    /* 选择结果变了才触发 PendSV 做任务切换 */
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
 
-            if (xConstTickCount < pxHead->xItemValue)
-            {
-                /* 还没到时间，更新下次唤醒时间，退出 */
-                xNextTaskUnblockTime = pxHead->xItemValue;
-                break;
-            }
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+}
 
-            /* 到时间了！从延时链表移除 */
-            pxTCB = (TCB_t *)pxHead->pvOwner;
-            uxListRemove(pxHead);
+/*把 BASEPRI 提到 configMAX_SYSCALL_INTERRUPT_PRIORITY，屏蔽能调用内核 API 的中断*/
+void vPortRaiseBASEPRI(void)
+{
+    __set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    __DSB();
+    __ISB();
+}
 
-            /* 如果任务还在队列等待链表上，也移除 ← 新增 */
-            if (pxTCB->xEventListItem.pvContainer != NULL)
-            {
-                uxListRemove(&(pxTCB->xEventListItem));
-            }
+/*提升 BASEPRI 并返回原来的值，给中断里的临界区用（可嵌套）*/
+uint32_t ulPortRaiseBASEPRI(void)
+{
+    uint32_t ulOriginalBASEPRI = __get_BASEPRI();
 
-            /* 放回就绪链表 */
-            prvAddTaskToReadyList(pxTCB);
-        }
-    }
+    __set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    __DSB();
+    __ISB();
 
-    /* 触发 PendSV 做任务切换 */
-    portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    return ulOriginalBASEPRI;
+}
 
-    taskENABLE_INTERRUPTS();
+/*设置 BASEPRI，0 表示不屏蔽任何中断*/
+void vPortSetBASEPRI(uint32_t ulNewMaskValue)
+{
+    __set_BASEPRI(ulNewMaskValue);
 }
 
 /*进入临界区，支持嵌套*/
@@ -461,17 +1040,78 @@ void vPortExitCritical(void)
     }
 }
 
-/*从就绪链表中移除任务 同时更新优先级位图*/
-void prvRemoveTaskFromReadyList(TCB_t *pxTCB)
+/*把任务从就绪链表摘下 同时更新优先级位图*/
+static void prvUnlinkReadyTask(TCB_t *pxTCB)
 {
     /* 从链表中移除，返回剩余节点数 */
     if (uxListRemove(&(pxTCB->xStateListItem)) == 0)
     {
         /* 这个优先级没有任务了，清除位图中对应的位 */
-        uxTopReadyPriority &= ~(1UL << pxTCB->uxPriority);
+        taskRESET_READY_PRIORITY(pxTCB->uxPriority);
     }
 }
 
+/*任务离开就绪态（阻塞/挂起）时从就绪链表中移除*/
+void prvRemoveTaskFromReadyList(TCB_t *pxTCB)
+{
+    prvUnlinkReadyTask(pxTCB);
+
+#if configUSE_EDF_SCHEDULING
+    /* 非周期 EDF 任务：这次作业结束，下次就绪时重新计算截止时间 */
+    if (pxTCB->xRelativeDeadline != 0 && pxTCB->xPeriod == 0)
+    {
+        pxTCB->xEdfJobPending = 1;
+    }
+#endif
+}
+
+/*当前任务阻塞在事件等待链表上（队列/信号量/互斥量/事件组）,
+  必须在临界区内调用，退出临界区后由调用者触发切换,
+  等待链表按优先级排序，唤醒时总是先放出优先级最高的任务*/
+void vTaskPlaceOnEventList(List_t *pxEventList, uint32_t xTicksToWait)
+{
+    /* 优先级越高值越小，排在越前面 */
+    pxCurrentTCB->xEventListItem.xItemValue = taskEVENT_LIST_ITEM_VALUE(pxCurrentTCB->uxPriority);
+
+    /* 从就绪链表移除，按优先级插入等待链表 */
+    prvRemoveTaskFromReadyList(pxCurrentTCB);
+    vListInsert(pxEventList, &(pxCurrentTCB->xEventListItem));
+
+    /* 加入延时时间轮（超时），死等只在等待链表里 */
+    if (xTicksToWait < 0xFFFFFFFFUL)
+    {
+        prvAddCurrentTaskToDelayedList(xTicksToWait);
+    }
+}
+
+/*唤醒挂在事件等待链表上的某个任务（事件组按条件挑任务，不一定是第一个）,
+  必须在临界区内调用，任务和中断共用，
+  返回 1 表示被唤醒的任务应该抢占当前任务，由调用者决定何时触发 PendSV*/
+uint32_t xTaskRemoveItemFromEventList(ListItem_t *pxEventListItem)
+{
+    TCB_t *pxTCB = (TCB_t *)pxEventListItem->pvOwner;
+
+    /* 从事件等待链表移除 */
+    uxListRemove(pxEventListItem);
+
+    /* 从延时时间轮移除（如果在的话） */
+    if (pxTCB->xStateListItem.pvContainer != NULL)
+    {
+        uxListRemove(&(pxTCB->xStateListItem));
+    }
+
+    /* 放回就绪链表 */
+    prvAddTaskToReadyList(pxTCB);
+
+    return prvTaskPreemptsCurrent(pxTCB);
+}
+
+/*唤醒事件等待链表（队列/信号量/互斥量）上的第一个任务，规则同上*/
+uint32_t xTaskRemoveFromEventList(List_t *pxEventList)
+{
+    return xTaskRemoveItemFromEventList(pxEventList->xListEnd.pxNext);
+}
+
 /*挂起任务,
   把任务从就绪链表移到挂起链表
   如果挂起的是当前任务，立刻切换*/
@@ -530,8 +1170,8 @@ void vTaskResume(TaskHandle_t xTaskToResume)
         /* 加回就绪链表 */
         prvAddTaskToReadyList(pxTCB);
 
-        /* 如果恢复的任务优先级更高，触发切换 */
-        if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+        /* 恢复的任务比当前任务更该运行（更高优先级，或 EDF 带内截止时间更早），触发切换 */
+        if (prvTaskPreemptsCurrent(pxTCB))
         {
             portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
         }
@@ -561,7 +1201,7 @@ void vTaskDelete(TaskHandle_t xTaskToDelete)
         uxListRemove(&(pxTCB->xStateListItem));
         if (pxReadyTasksLists[pxTCB->uxPriority].uxNumberOfItems == 0)
         {
-            uxTopReadyPriority &= ~(1UL << pxTCB->uxPriority);
+            taskRESET_READY_PRIORITY(pxTCB->uxPriority);
         }
     }
 
@@ -570,6 +1210,18 @@ void vTaskDelete(TaskHandle_t xTaskToDelete)
         uxListRemove(&(pxTCB->xEventListItem));
     }
 
+    /* 删的是阻塞在队列上（或刚被唤醒还没撤销登记）的任务，替它撤销登记 */
+    if (pxTCB->pxWaitingOnQueue != NULL)
+    {
+        prvQueueWaitAbandoned(pxTCB);
+    }
+
+    /* 流缓冲区同理，还要清掉指向这个 TCB 的等待者句柄，免得以后通知到已释放的内存 */
+    if (pxTCB->pxWaitingOnStreamBuffer != NULL)
+    {
+        prvStreamBufferWaitAbandoned(pxTCB);
+    }
+
     if (pxTCB == pxCurrentTCB)
     {
         /* 删除自己：标记让空闲任务回收 */
@@ -587,6 +1239,28 @@ void vTaskDelete(TaskHandle_t xTaskToDelete)
     }
 }
 
+/*
+ * 设置任务调度策略
+ *   xTask       : 任务句柄，NULL 表示自己
+ *   ulPolicy    : taskSCHED_RR（时间片轮转）或 taskSCHED_FIFO（不分时间片）
+ *   ulTimeSlice : RR 时间片长度（tick），0 表示用默认值 configTIME_SLICE_TICKS
+ */
+void vTaskSetSchedPolicy(TaskHandle_t xTask, uint32_t ulPolicy, uint32_t ulTimeSlice)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : xTask;
+
+    if (ulTimeSlice == 0)
+        ulTimeSlice = configTIME_SLICE_TICKS;
+
+    taskENTER_CRITICAL();
+
+    pxTCB->ulSchedPolicy = ulPolicy;
+    pxTCB->ulTimeSlice = ulTimeSlice;
+    pxTCB->ulTimeSliceRemaining = ulTimeSlice;
+
+    taskEXIT_CRITICAL();
+}
+
 /*线程安全打印*/
 void vSafePrintf(const char *fmt, ...)
 {
@@ -601,42 +1275,47 @@ void vSafePrintf(const char *fmt, ...)
     taskEXIT_CRITICAL();
 }
 
-/*初始化两个延时链表*/
+/*初始化延时时间轮*/
 static void prvInitialiseDelayLists(void)
 {
-    vListInit(&xDelayedTaskList1);
-    vListInit(&xDelayedTaskList2);
+    uint32_t i;
+
+    for (i = 0; i < configDELAY_WHEEL_SLOTS; i++)
+    {
+        vListInit(&xDelayedTaskWheel[i]);
+    }
+
+    for (i = 0; i < taskDELAY_WHEEL_WORDS; i++)
+    {
+        uxDelayWheelBitmap[i] = 0;
+    }
 
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    xDelayedTasksPending = 0;
 }
 
-/*把任务加入延时链表,根据唤醒时间是否溢出，放入不同的链表*/
+/*把任务加入延时时间轮，按唤醒时间挂到对应的槽上，O(1)*/
 void prvAddCurrentTaskToDelayedList(uint32_t xTicksToDelay)
 {
+    const uint32_t xConstTickCount = xTickCount;
     uint32_t xTimeToWake;
 
-    /* 计算唤醒时间 */
-    xTimeToWake = xTickCount + xTicksToDelay;
+    /* 计算唤醒时间（溢出后自然取模） */
+    xTimeToWake = xConstTickCount + xTicksToDelay;
 
-    /* 设置节点排序值为唤醒时间 */
+    /* 节点值记录唤醒时间，到期判断用 */
     pxCurrentTCB->xStateListItem.xItemValue = xTimeToWake;
 
-    if (xTimeToWake < xTickCount)
-    {
-        /* 溢出了，放入溢出链表 */
-        vListInsert(pxOverflowDelayedTaskList, &(pxCurrentTCB->xStateListItem));
-    }
-    else
-    {
-        /* 没溢出，放入当前延时链表 */
-        vListInsert(pxDelayedTaskList, &(pxCurrentTCB->xStateListItem));
+    /* 槽内不排序，直接插到末尾，并在位图里标记 */
+    vListInsertEnd(&xDelayedTaskWheel[xTimeToWake & taskDELAY_WHEEL_MASK],
+                   &(pxCurrentTCB->xStateListItem));
+    uxDelayWheelBitmap[(xTimeToWake & taskDELAY_WHEEL_MASK) >> 5] |= (1UL << (xTimeToWake & 31UL));
 
-        /* 更新最近唤醒时间 */
-        if (xTimeToWake < xNextTaskUnblockTime)
-        {
-            xNextTaskUnblockTime = xTimeToWake;
-        }
+    /* 更新最近唤醒时间（按到当前 tick 的距离比较） */
+    if (xDelayedTasksPending == 0 ||
+        xTicksToDelay < (xNextTaskUnblockTime - xConstTickCount))
+    {
+        xNextTaskUnblockTime = xTimeToWake;
+        xDelayedTasksPending = 1;
     }
 }
 
@@ -664,6 +1343,321 @@ void vTaskDelay(uint32_t xTicksToDelay)
     portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
 }
 
+/*
+ * 按绝对时间周期延时，周期不随任务执行时间漂移
+ *   pxPreviousWakeTime : 上一次唤醒时间，首次调用前初始化为 xTaskGetTickCount()，由本函数更新
+ *   xTimeIncrement     : 周期（tick）
+ *   返回               : 错过的周期数，0 表示按时
+ *
+ * 唤醒时间按 32 位取模计算（和延时时间轮一样），tick 溢出不影响。
+ * 超期时跳过已经错过的释放点，保持原来的相位，不连续补跑。
+ */
+uint32_t xTaskDelayUntil(uint32_t *pxPreviousWakeTime, uint32_t xTimeIncrement)
+{
+    uint32_t xElapsed;
+    uint32_t xMissedPeriods;
+    uint32_t xTimeToWake;
+    uint32_t xTicksToDelay;
+
+    if (xTimeIncrement == 0)
+        return 0;
+
+    taskENTER_CRITICAL();
+
+    /* 距离上次唤醒过去了多久 */
+    xElapsed = xTickCount - *pxPreviousWakeTime;
+
+    /* 严格早于当前时刻的释放点个数（正好落在当前时刻的不算错过） */
+    xMissedPeriods = (xElapsed == 0) ? 0 : ((xElapsed - 1) / xTimeIncrement);
+
+    /* 下一个不早于当前时刻的释放点 */
+    xTimeToWake = *pxPreviousWakeTime + ((xMissedPeriods + 1) * xTimeIncrement);
+    *pxPreviousWakeTime = xTimeToWake;
+
+    xTicksToDelay = xTimeToWake - xTickCount;
+    if (xTicksToDelay > 0)
+    {
+        prvRemoveTaskFromReadyList(pxCurrentTCB);
+        prvAddCurrentTaskToDelayedList(xTicksToDelay);
+    }
+
+    taskEXIT_CRITICAL();
+
+    if (xTicksToDelay > 0)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    return xMissedPeriods;
+}
+
+/*
+ * 记录阻塞开始的时刻，配合 xTaskCheckForTimeOut 计算剩余等待时间
+ */
+void vTaskSetTimeOutState(TimeOut_t *pxTimeOut)
+{
+    pxTimeOut->xTimeOnEntering = xTickCount;
+}
+
+/*
+ * 被唤醒后检查是否真的超时
+ *   pxTicksToWait : 进来时是上次剩下的等待时间，没超时改成新的剩余时间，超时改成 0
+ *   返回          : 1 已超时，0 还没超时（可以带着剩余时间再阻塞）
+ *
+ * 经过的时间按 32 位取模计算，tick 溢出不影响；死等（0xFFFFFFFF）永远不超时。
+ * 没超时时把起点挪到现在，下一轮接着从剩余时间里扣
+ */
+uint32_t xTaskCheckForTimeOut(TimeOut_t *pxTimeOut, uint32_t *pxTicksToWait)
+{
+    uint32_t xConstTickCount;
+    uint32_t xElapsed;
+    uint32_t xReturn;
+
+    if (*pxTicksToWait == 0xFFFFFFFFUL)
+        return 0;
+
+    taskENTER_CRITICAL();
+
+    xConstTickCount = xTickCount;
+    xElapsed = xConstTickCount - pxTimeOut->xTimeOnEntering;
+
+    if (xElapsed < *pxTicksToWait)
+    {
+        *pxTicksToWait -= xElapsed;
+        pxTimeOut->xTimeOnEntering = xConstTickCount;
+        xReturn = 0;
+    }
+    else
+    {
+        *pxTicksToWait = 0;
+        xReturn = 1;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/*按动作修改通知值，目标任务正在等通知就唤醒它，
+  必须在临界区内调用，需要切换时置 *pxSwitchRequired = 1*/
+static int32_t prvNotify(TCB_t *pxTCB, uint32_t ulValue, eNotifyAction eAction,
+                         uint32_t *pxSwitchRequired)
+{
+    uint8_t ucOriginalNotifyState = pxTCB->ucNotifyState;
+
+    pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+
+    switch (eAction)
+    {
+    case eSetBits:
+        pxTCB->ulNotifiedValue |= ulValue;
+        break;
+
+    case eIncrement:
+        pxTCB->ulNotifiedValue++;
+        break;
+
+    case eSetValueWithOverwrite:
+        pxTCB->ulNotifiedValue = ulValue;
+        break;
+
+    case eSetValueWithoutOverwrite:
+        if (ucOriginalNotifyState == taskNOTIFICATION_RECEIVED)
+        {
+            /* 上一个值还没被取走，不覆盖 */
+            return -1;
+        }
+        pxTCB->ulNotifiedValue = ulValue;
+        break;
+
+    case eNoAction:
+    default:
+        break;
+    }
+
+    /*
+     * 只唤醒真正阻塞着的任务：等通知超时后已经被 SysTick 放回就绪链表、
+     * 但还没运行到把状态改回来的任务，不能再插一次就绪链表；
+     * 等通知时被挂起的任务保持挂起，通知只记下来，vTaskResume 后它就能看到
+     */
+    if (ucOriginalNotifyState == taskWAITING_NOTIFICATION &&
+        pxTCB->xStateListItem.pvContainer != &pxReadyTasksLists[pxTCB->uxPriority] &&
+        pxTCB->xStateListItem.pvContainer != &xSuspendedTaskList)
+    {
+        /* 从延时时间轮移除（死等时不在任何链表上） */
+        if (pxTCB->xStateListItem.pvContainer != NULL)
+        {
+            uxListRemove(&(pxTCB->xStateListItem));
+        }
+
+        prvAddTaskToReadyList(pxTCB);
+
+        if (prvTaskPreemptsCurrent(pxTCB))
+        {
+            *pxSwitchRequired = 1;
+        }
+    }
+
+    return 0;
+}
+
+/*当前任务阻塞等通知，必须在临界区内调用，退出临界区后由调用者触发切换*/
+static void prvWaitForNotification(uint32_t xTicksToWait)
+{
+    pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+
+    /* 从就绪链表移除 */
+    prvRemoveTaskFromReadyList(pxCurrentTCB);
+
+    /* 有超时就挂到时间轮上，死等时不挂任何链表，只能被通知唤醒 */
+    if (xTicksToWait < 0xFFFFFFFFUL)
+    {
+        prvAddCurrentTaskToDelayedList(xTicksToWait);
+    }
+}
+
+/*给任务发通知*/
+int32_t xTaskNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction)
+{
+    uint32_t xSwitchRequired = 0;
+    int32_t xReturn;
+
+    taskENTER_CRITICAL();
+    xReturn = prvNotify(xTaskToNotify, ulValue, eAction, &xSwitchRequired);
+    taskEXIT_CRITICAL();
+
+    if (xSwitchRequired)
+    {
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+    }
+
+    return xReturn;
+}
+
+/*在中断中给任务发通知，不触发切换，由中断退出前 portYIELD_FROM_ISR 统一切换*/
+int32_t xTaskNotifyFromISR(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction,
+                           uint32_t *pxHigherPriorityTaskWoken)
+{
+    uint32_t xSwitchRequired = 0;
+    uint32_t ulSavedInterruptStatus;
+    int32_t xReturn;
+
+    ulSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    xReturn = prvNotify(xTaskToNotify, ulValue, eAction, &xSwitchRequired);
+    taskEXIT_CRITICAL_FROM_ISR(ulSavedInterruptStatus);
+
+    if (xSwitchRequired && pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = 1;
+    }
+
+    return xReturn;
+}
+
+/*把通知当信号量取：通知值为 0 时阻塞等待，返回取走前的通知值*/
+uint32_t ulTaskNotifyTake(uint32_t xClearCountOnExit, uint32_t xTicksToWait)
+{
+    uint32_t ulReturn;
+
+    taskENTER_CRITICAL();
+
+    if (pxCurrentTCB->ulNotifiedValue == 0 && xTicksToWait != 0)
+    {
+        prvWaitForNotification(xTicksToWait);
+        taskEXIT_CRITICAL();
+
+        /* 触发切换，被通知或超时唤醒后从这里继续 */
+        portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+        taskENTER_CRITICAL();
+    }
+
+    ulReturn = pxCurrentTCB->ulNotifiedValue;
+
+    if (ulReturn != 0)
+    {
+        if (xClearCountOnExit != 0)
+        {
+            pxCurrentTCB->ulNotifiedValue = 0;
+        }
+        else
+        {
+            pxCurrentTCB->ulNotifiedValue = ulReturn - 1;
+        }
+    }
+
+    pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+
+    taskEXIT_CRITICAL();
+
+    return ulReturn;
+}
+
+/*等待通知：收到通知返回 0 并输出通知值，超时返回 -1*/
+int32_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry,
+                        uint32_t ulBitsToClearOnExit,
+                        uint32_t *pulNotificationValue,
+                        uint32_t xTicksToWait)
+{
+    int32_t xReturn;
+
+    taskENTER_CRITICAL();
+
+    /* 还没有待取的通知才清进入位并阻塞 */
+    if (pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED)
+    {
+        pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+
+        if (xTicksToWait != 0)
+        {
+            prvWaitForNotification(xTicksToWait);
+            taskEXIT_CRITICAL();
+
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+
+            taskENTER_CRITICAL();
+        }
+    }
+
+    if (pulNotificationValue != NULL)
+    {
+        /* 超时也输出当前值 */
+        *pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+    }
+
+    if (pxCurrentTCB->ucNotifyState == taskNOTIFICATION_RECEIVED)
+    {
+        pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+        xReturn = 0;
+    }
+    else
+    {
+        /* 超时，没收到通知 */
+        xReturn = -1;
+    }
+
+    pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/*清除待取的通知状态（不改通知值），用通知做内核对象的唤醒时，阻塞前先清掉旧的通知*/
+void vTaskNotifyStateClear(TaskHandle_t xTask)
+{
+    TCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : xTask;
+
+    taskENTER_CRITICAL();
+
+    if (pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED)
+    {
+        pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+    }
+
+    taskEXIT_CRITICAL();
+}
+
 /*修改任务优先级  从旧优先级的就绪链表移除，加入新优先级的就绪链表*/
 void vTaskPrioritySet(TCB_t *pxTCB, uint32_t uxNewPriority)
 {
@@ -677,7 +1671,8 @@ void vTaskPrioritySet(TCB_t *pxTCB, uint32_t uxNewPriority)
     if (pxTCB->xStateListItem.pvContainer ==
         &pxReadyTasksLists[pxTCB->uxPriority])
     {
-        prvRemoveTaskFromReadyList(pxTCB);
+        /* 只是换优先级，任务没有离开就绪态 */
+        prvUnlinkReadyTask(pxTCB);
         pxTCB->uxPriority = uxNewPriority;
         prvAddTaskToReadyList(pxTCB);
     }
@@ -686,6 +1681,16 @@ void vTaskPrioritySet(TCB_t *pxTCB, uint32_t uxNewPriority)
         /* 在延时/挂起/等待链表中，只改优先级值 */
         pxTCB->uxPriority = uxNewPriority;
     }
+
+    /* 还在事件等待链表上（比如被继承优先级的持有者正等别的队列），按新优先级重新排队 */
+    if (pxTCB->xEventListItem.pvContainer != NULL)
+    {
+        List_t *pxEventList = pxTCB->xEventListItem.pvContainer;
+
+        uxListRemove(&(pxTCB->xEventListItem));
+        pxTCB->xEventListItem.xItemValue = taskEVENT_LIST_ITEM_VALUE(uxNewPriority);
+        vListInsert(pxEventList, &(pxTCB->xEventListItem));
+    }
 }
 
 /*启动调度器*/
@@ -695,12 +1700,17 @@ void vTaskStartScheduler(void)
     vListInit(&xSuspendedTaskList);
     vListInit(&xTasksWaitingTermination);
 
-    /* 初始化延时链表 */
+    /* 初始化延时时间轮 */
     prvInitialiseDelayLists();
 
     /* 创建空闲任务 */
     prvCreateIdleTask();
 
+#if configUSE_TIMERS
+    /* 创建定时器服务任务 */
+    xTimerCreateTimerTask();
+#endif
+
     /* 选出最高优先级任务 */
     prvSelectHighestPriorityTask();
 
@@ -708,6 +1718,9 @@ void vTaskStartScheduler(void)
     (*((volatile uint32_t *)0xE000ED20)) |= (0xFFUL << 16);
     (*((volatile uint32_t *)0xE000ED20)) |= (0xFFUL << 24);
 
+    /* FPCCR: ASPEN + LSPEN，异常入口自动保存 FPU 上下文并使用懒压栈 */
+    (*((volatile uint32_t *)0xE000EF34)) |= (0x3UL << 30);
+
     /* 启动 SysTick */
     prvStartSysTick();
 
@@ -19,25 +19,98 @@
 #define portNVIC_PENDSVSET_BIT (1UL << 28UL)                       /*ICSR 里的第 28 位，写 1 会把 PendSV 置为 pending。*/
 
 /*任务配置宏*/
-#define MAX_PRIORITIES 8   /* 优先级 0~7，数字越大优先级越高 */
+#ifndef MAX_PRIORITIES
+#define MAX_PRIORITIES 8 /* 优先级 0~MAX_PRIORITIES-1，数字越大优先级越高，可在编译选项中覆盖，最大 1024 */
+#endif
 #define TASK_STACK_MIN 128 /* 最小栈大小（单位：uint32_t = 字） */
 #define TASK_NAME_LEN 16
 
 /*系统节拍配置宏*/
 #define configTICK_RATE_HZ 1000 /* 系统节拍频率1ms 一次 */
 
+/*调度策略和时间片配置宏*/
+#define taskSCHED_RR 0             /* 同优先级轮转：时间片用完让给下一个同优先级任务 */
+#define taskSCHED_FIFO 1           /* 先进先出：不分时间片，一直运行到阻塞或主动让出 */
+#define configTIME_SLICE_TICKS 1   /* RR 任务默认时间片（tick） */
+
+/*EDF（最早截止时间优先）调度配置宏*/
+#define configUSE_EDF_SCHEDULING 1                 /* 1：启用 EDF 调度类 */
+#define configEDF_PRIORITY (MAX_PRIORITIES - 2)    /* EDF 任务所在的固定优先级带，带内按截止时间调度 */
+
+/*软件定时器配置宏*/
+#ifndef configUSE_TIMERS
+#define configUSE_TIMERS 0 /* 1：编译 timers.c，调度器启动时创建定时器服务任务；默认关，服务任务栈和命令队列要占 1KB 多 RAM */
+#endif
+
+/*延时时间轮配置宏*/
+/*
+ * 时间轮槽数，必须是 2 的幂且不小于 32，每槽一个 List_t。
+ * 下一次唤醒时间只精确到“下一个非空槽”，所以 tickless 一次最多睡这么多 tick：
+ * 只有一个长延时任务时（比如延时 10 秒），默认 64 槽仍然每 64ms 醒一次检查。
+ * 更在乎功耗就调大（每槽多占一个 List_t 的 RAM），更在乎 RAM 就保持默认
+ */
+#define configDELAY_WHEEL_SLOTS 64
+
+/*低功耗配置宏*/
+#define configUSE_TICKLESS_IDLE 1               /* 1：只剩空闲任务就绪时停掉节拍，睡到下一个唤醒时间点 */
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2 /* 预计空闲 tick 数不少于该值才进入睡眠 */
+
+/*中断优先级配置宏*/
+#define configPRIO_BITS 4                              /* STM32F4 NVIC 实现 4 位优先级 */
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 5 /* 能调用内核 API 的最高中断优先级（数值） */
+/*
+ * 写入 BASEPRI 的值：临界区只屏蔽优先级数值 >= 5 的中断，
+ * 0~4 的中断（如电机换相）永远不会被内核延迟，但它们也不能调用任何内核 API
+ */
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
 /* 将临界区函数配置为快捷宏 */
 #define taskENTER_CRITICAL() vPortEnterCritical()
 #define taskEXIT_CRITICAL() vPortExitCritical()
 
-/* 中断级临界区（在中断中使用），不计数没有嵌套保护 */
-#define taskDISABLE_INTERRUPTS() __asm volatile("CPSID I")
-#define taskENABLE_INTERRUPTS() __asm volatile("CPSIE I")
+/* 中断级临界区（在中断中使用），不计数没有嵌套保护，用 BASEPRI 屏蔽 */
+#define taskDISABLE_INTERRUPTS() vPortRaiseBASEPRI()
+#define taskENABLE_INTERRUPTS() vPortSetBASEPRI(0)
+
+/*
+ * 中断里用的临界区：保存进入前的 BASEPRI，退出时恢复，
+ * 允许嵌套在任务临界区或其他中断临界区里面
+ *   uint32_t ulSaved = taskENTER_CRITICAL_FROM_ISR();
+ *   ...
+ *   taskEXIT_CRITICAL_FROM_ISR(ulSaved);
+ */
+#define taskENTER_CRITICAL_FROM_ISR() ulPortRaiseBASEPRI()
+#define taskEXIT_CRITICAL_FROM_ISR(x) vPortSetBASEPRI(x)
+
+/* 中断退出前统一切换一次：FromISR 系列 API 报告唤醒了更高优先级任务时才触发 PendSV */
+#define portYIELD_FROM_ISR(xSwitchRequired)                 \
+    do                                                      \
+    {                                                       \
+        if ((xSwitchRequired) != 0)                         \
+        {                                                   \
+            portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT; \
+        }                                                   \
+    } while (0)
 
 /*---------------------------------------------------------------------------
  *  数据结构
  *---------------------------------------------------------------------------*/
 
+/*任务通知状态*/
+#define taskNOT_WAITING_NOTIFICATION 0 /* 没在等通知 */
+#define taskWAITING_NOTIFICATION 1     /* 阻塞等待通知 */
+#define taskNOTIFICATION_RECEIVED 2    /* 收到通知还没被取走 */
+
+/*任务通知动作*/
+typedef enum
+{
+    eNoAction = 0,            /* 只唤醒，不改通知值 */
+    eSetBits,                 /* 通知值 |= ulValue（当事件标志用） */
+    eIncrement,               /* 通知值 +1（当计数信号量用） */
+    eSetValueWithOverwrite,   /* 通知值 = ulValue，覆盖未读的值（当长度 1 的邮箱用） */
+    eSetValueWithoutOverwrite /* 通知值 = ulValue，上一个值没被取走就失败 */
+} eNotifyAction;
+
 /*任务函数类型*/
 typedef void (*TaskFunction_t)(void *param);
 
@@ -51,6 +124,27 @@ typedef struct TCB
 
     uint32_t uxPriority; /* 优先级 */
 
+    uint32_t ulSchedPolicy;        /* 调度策略：taskSCHED_RR / taskSCHED_FIFO */
+    uint32_t ulTimeSlice;          /* RR 时间片长度（tick） */
+    uint32_t ulTimeSliceRemaining; /* 当前时间片还剩多少 tick，被抢占时保留 */
+
+    volatile uint32_t ulNotifiedValue; /* 任务通知值 */
+    volatile uint8_t ucNotifyState;    /* 通知状态：taskNOT_WAITING_NOTIFICATION 等 */
+
+    uint32_t ulEventWaitBits; /* 事件组：阻塞时存等待的位和控制位，唤醒时存唤醒那一刻的事件位 */
+
+    struct QueueDefinition *pxWaitingOnQueue;                /* 正在阻塞流程里的队列/互斥量，删除任务时撤销它的等待登记 */
+    struct StreamBufferDefinition *pxWaitingOnStreamBuffer;  /* 正在阻塞流程里的流/消息缓冲区，同上 */
+    uint8_t ucQueuePeek;                                     /* 1：等在接收链表上的是 xQueuePeek，不会取走元素 */
+
+#if configUSE_EDF_SCHEDULING
+    uint32_t xRelativeDeadline; /* 相对截止时间（tick），0 表示普通固定优先级任务 */
+    uint32_t xPeriod;           /* 周期（tick），0 表示非周期任务 */
+    uint32_t xAbsoluteDeadline; /* 当前作业的绝对截止时间，EDF 就绪链表按它排序 */
+    uint32_t xNextRelease;      /* 周期任务当前作业的释放时间 */
+    uint32_t xEdfJobPending;    /* 非周期任务离开过就绪态，下次就绪时开始新作业 */
+#endif
+
     uint32_t *pxStack;    /* 栈底地址（用于检测溢出） */
     uint32_t ulStackSize; /* 栈大小 */
 
@@ -59,6 +153,12 @@ typedef struct TCB
 
 typedef TCB_t *TaskHandle_t;
 
+/*阻塞超时状态：被唤醒后没拿到资源时，按剩余时间继续等，而不是直接超时*/
+typedef struct TimeOut
+{
+    uint32_t xTimeOnEntering; /* 本轮阻塞开始的 tick */
+} TimeOut_t;
+
 /*---------------------------------------------------------------------------
  *  函数声明
  *---------------------------------------------------------------------------*/
@@ -68,17 +168,61 @@ int32_t xTaskCreate(TaskFunction_t pxTaskCode,
                     void *pvParam,
                     uint32_t uxPriority,
                     TaskHandle_t *pxHandle);
+#if configUSE_EDF_SCHEDULING
+int32_t xTaskCreateEDF(TaskFunction_t pxTaskCode,
+                       const char *pcName,
+                       uint32_t ulStackSize,
+                       void *pvParam,
+                       uint32_t xRelativeDeadline,
+                       uint32_t xPeriod,
+                       TaskHandle_t *pxHandle);
+void vTaskWaitForNextPeriod(void);
+#endif
 void vTaskStartScheduler(void);
 void taskYIELD(void);
 void vTaskSwitchContext(void);
 uint32_t xTaskGetTickCount(void);
 void vPortEnterCritical(void);
 void vPortExitCritical(void);
+void vPortRaiseBASEPRI(void);
+void vPortSetBASEPRI(uint32_t ulNewMaskValue);
+uint32_t ulPortRaiseBASEPRI(void);
 void vApplicationIdleHook(void);
 void vTaskSuspend(TaskHandle_t xTaskToSuspend);
 void vTaskResume(TaskHandle_t xTaskToResume);
 void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskSetSchedPolicy(TaskHandle_t xTask, uint32_t ulPolicy, uint32_t ulTimeSlice);
 void vTaskDelay(uint32_t xTicksToDelay);
+uint32_t xTaskDelayUntil(uint32_t *pxPreviousWakeTime, uint32_t xTimeIncrement);
+void vTaskSetTimeOutState(TimeOut_t *pxTimeOut);
+uint32_t xTaskCheckForTimeOut(TimeOut_t *pxTimeOut, uint32_t *pxTicksToWait);
+
+/*
+ * 任务通知：直接给某个任务发信号，不需要队列/信号量对象
+ *   xTaskNotify           : 按 eAction 修改目标任务的通知值并唤醒它，
+ *                           eSetValueWithoutOverwrite 且上一个值未取走时返回 -1，其余返回 0
+ *   xTaskNotifyFromISR    : 中断版本，唤醒了更该运行的任务时置 *pxHigherPriorityTaskWoken = 1
+ *   ulTaskNotifyTake      : 当二值/计数信号量用，等通知值非 0，返回取走前的值，超时返回 0
+ *                           xClearCountOnExit 非 0 时清零（二值），否则减一（计数）
+ *   xTaskNotifyWait       : 当事件标志/邮箱用，进入时清 ulBitsToClearOnEntry，
+ *                           收到后把值写到 *pulNotificationValue（可传 NULL）再清 ulBitsToClearOnExit，
+ *                           返回 0 收到通知，-1 超时
+ *   vTaskNotifyStateClear : 丢掉还没被取走的通知（不改通知值），NULL 表示自己
+ */
+int32_t xTaskNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction);
+int32_t xTaskNotifyFromISR(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction,
+                           uint32_t *pxHigherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(uint32_t xClearCountOnExit, uint32_t xTicksToWait);
+int32_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry,
+                        uint32_t ulBitsToClearOnExit,
+                        uint32_t *pulNotificationValue,
+                        uint32_t xTicksToWait);
+void vTaskNotifyStateClear(TaskHandle_t xTask);
+#define xTaskNotifyGive(xTaskToNotify) \
+    xTaskNotify((xTaskToNotify), 0, eIncrement)
+#define vTaskNotifyGiveFromISR(xTaskToNotify, pxHigherPriorityTaskWoken) \
+    xTaskNotifyFromISR((xTaskToNotify), 0, eIncrement, (pxHigherPriorityTaskWoken))
+
 void prvCreateIdleTask(void);
 void prvAddTaskToReadyList(TCB_t *pxTCB);
 /* 供 mutex.c 使用的优先级操作 */
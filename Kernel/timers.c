@@ -0,0 +1,326 @@
+#include "timers.h"
+#include "heap.h"
+
+/* 没打开 configUSE_TIMERS 时整个文件不参与编译，调用定时器 API 会链接失败 */
+#if configUSE_TIMERS
+
+/*---------------------------------------------------------------------------
+ *  命令队列里的消息
+ *---------------------------------------------------------------------------*/
+typedef struct TimerCommand
+{
+    int32_t xCommandID;     /* tmrCOMMAND_xxx */
+    uint32_t xMessageValue; /* 启动/复位：发出命令时的 tick；改周期：新周期 */
+    Timer_t *pxTimer;       /* 操作哪个定时器 */
+} TimerCommand_t;
+
+/*---------------------------------------------------------------------------
+ *  服务任务私有数据
+ *
+ *  活动定时器链表按到期时间排序（vListInsertWrapped，tick 溢出不影响），
+ *  只有服务任务自己会改它，其他任务和中断都通过命令队列间接操作，不需要临界区
+ *---------------------------------------------------------------------------*/
+static List_t xActiveTimerList;
+static QueueHandle_t xTimerQueue = NULL;
+
+/*---------------------------------------------------------------------------
+ *  第一次使用时创建链表和命令队列（内部函数）
+ *
+ *  调度器启动前就可以创建和启动定时器，命令先在队列里排着
+ *---------------------------------------------------------------------------*/
+static int32_t prvCheckForValidListAndQueue(void)
+{
+    taskENTER_CRITICAL();
+
+    if (xTimerQueue == NULL)
+    {
+        vListInit(&xActiveTimerList);
+        xTimerQueue = xQueueCreate(configTIMER_QUEUE_LENGTH, sizeof(TimerCommand_t));
+    }
+
+    taskEXIT_CRITICAL();
+
+    return (xTimerQueue != NULL) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------------
+ *  创建定时器
+ *---------------------------------------------------------------------------*/
+TimerHandle_t xTimerCreate(const char *pcTimerName,
+                           uint32_t xTimerPeriodInTicks,
+                           uint32_t uxAutoReload,
+                           void *pvTimerID,
+                           TimerCallbackFunction_t pxCallbackFunction)
+{
+    Timer_t *pxNewTimer;
+
+    if (xTimerPeriodInTicks == 0)
+        return NULL;
+
+    if (prvCheckForValidListAndQueue() != 0)
+        return NULL;
+
+    pxNewTimer = (Timer_t *)pvPortMalloc(sizeof(Timer_t));
+    if (pxNewTimer == NULL)
+        return NULL;
+
+    pxNewTimer->pcTimerName = pcTimerName;
+    pxNewTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
+    pxNewTimer->uxAutoReload = uxAutoReload;
+    pxNewTimer->pvTimerID = pvTimerID;
+    pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+
+    /* 节点指向自己，不在任何链表上表示停止 */
+    vListInitItem(&(pxNewTimer->xTimerListItem));
+    pxNewTimer->xTimerListItem.pvOwner = pxNewTimer;
+
+    return pxNewTimer;
+}
+
+/*---------------------------------------------------------------------------
+ *  填命令消息（内部函数）
+ *
+ *  启动/复位从发出命令的时刻开始计时，命令在队列里排队的时间不算
+ *---------------------------------------------------------------------------*/
+static void prvInitialiseCommand(TimerCommand_t *pxMessage,
+                                 TimerHandle_t xTimer,
+                                 int32_t xCommandID,
+                                 uint32_t xOptionalValue)
+{
+    pxMessage->xCommandID = xCommandID;
+    pxMessage->pxTimer = xTimer;
+
+    if (xCommandID == tmrCOMMAND_CHANGE_PERIOD)
+    {
+        pxMessage->xMessageValue = xOptionalValue;
+    }
+    else
+    {
+        pxMessage->xMessageValue = xTickCount;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  发命令
+ *---------------------------------------------------------------------------*/
+int32_t xTimerGenericCommand(TimerHandle_t xTimer,
+                             int32_t xCommandID,
+                             uint32_t xOptionalValue,
+                             uint32_t xTicksToWait)
+{
+    TimerCommand_t xMessage;
+
+    if (xTimerQueue == NULL)
+        return -1;
+
+    prvInitialiseCommand(&xMessage, xTimer, xCommandID, xOptionalValue);
+
+    /* 调度器还没启动时没有当前任务，不能阻塞 */
+    if (pxCurrentTCB == NULL)
+    {
+        xTicksToWait = 0;
+    }
+
+    return xQueueSend(xTimerQueue, &xMessage, xTicksToWait);
+}
+
+/*---------------------------------------------------------------------------
+ *  在中断中发命令（不阻塞）
+ *
+ *  调用者不关心是否唤醒了高优先级任务（传 NULL）时用局部变量接住，
+ *  不管传不传都走中断版本的队列发送，不会在中断里进任务级临界区
+ *---------------------------------------------------------------------------*/
+int32_t xTimerGenericCommandFromISR(TimerHandle_t xTimer,
+                                    int32_t xCommandID,
+                                    uint32_t xOptionalValue,
+                                    uint32_t *pxHigherPriorityTaskWoken)
+{
+    TimerCommand_t xMessage;
+    uint32_t xDummyWoken = 0;
+
+    if (xTimerQueue == NULL)
+        return -1;
+
+    prvInitialiseCommand(&xMessage, xTimer, xCommandID, xOptionalValue);
+
+    if (pxHigherPriorityTaskWoken == NULL)
+    {
+        pxHigherPriorityTaskWoken = &xDummyWoken;
+    }
+
+    return xQueueSendFromISR(xTimerQueue, &xMessage, pxHigherPriorityTaskWoken);
+}
+
+/*---------------------------------------------------------------------------
+ *  按到期时间把定时器插入活动链表（内部函数）
+ *---------------------------------------------------------------------------*/
+static void prvInsertTimerInActiveList(Timer_t *pxTimer, uint32_t xExpiryTime)
+{
+    pxTimer->xTimerListItem.xItemValue = xExpiryTime;
+    vListInsertWrapped(&xActiveTimerList, &(pxTimer->xTimerListItem));
+}
+
+/*---------------------------------------------------------------------------
+ *  处理所有已经到期的定时器（内部函数）
+ *
+ *  回调可能执行很久，每处理一个都重新读一次 tick；
+ *  返回最后一次读到的 tick，此时链表头部（如果有）一定还没到期
+ *---------------------------------------------------------------------------*/
+static uint32_t prvProcessExpiredTimers(void)
+{
+    ListItem_t *pxItem;
+    Timer_t *pxTimer;
+    uint32_t xExpiryTime;
+    uint32_t xTimeNow;
+
+    for (;;)
+    {
+        xTimeNow = xTaskGetTickCount();
+
+        if (xActiveTimerList.uxNumberOfItems == 0)
+            break;
+
+        pxItem = xActiveTimerList.xListEnd.pxNext;
+        pxTimer = (Timer_t *)pxItem->pvOwner;
+        xExpiryTime = pxItem->xItemValue;
+
+        /* 链表有序，头部还没到期后面的都没到期 */
+        if ((int32_t)(xExpiryTime - xTimeNow) > 0)
+            break;
+
+        uxListRemove(pxItem);
+
+        /*
+         * 自动重装：下一次到期时间按上一次到期时间加周期算，不随处理延迟漂移；
+         * 服务任务被耽误了好几个周期时，重新插入后仍然到期，会连续补调回调
+         */
+        if (pxTimer->uxAutoReload != 0)
+        {
+            prvInsertTimerInActiveList(pxTimer, xExpiryTime + pxTimer->xTimerPeriodInTicks);
+        }
+
+        pxTimer->pxCallbackFunction(pxTimer);
+    }
+
+    return xTimeNow;
+}
+
+/*---------------------------------------------------------------------------
+ *  执行一条命令（内部函数）
+ *---------------------------------------------------------------------------*/
+static void prvProcessCommand(const TimerCommand_t *pxMessage)
+{
+    Timer_t *pxTimer = pxMessage->pxTimer;
+
+    /* 不管什么命令，先从活动链表拿下来 */
+    if (pxTimer->xTimerListItem.pvContainer != NULL)
+    {
+        uxListRemove(&(pxTimer->xTimerListItem));
+    }
+
+    switch (pxMessage->xCommandID)
+    {
+    case tmrCOMMAND_START:
+    case tmrCOMMAND_RESET:
+        /* 从发出命令的时刻开始计一个周期，命令排队太久已经过期的下一轮马上处理 */
+        prvInsertTimerInActiveList(pxTimer, pxMessage->xMessageValue + pxTimer->xTimerPeriodInTicks);
+        break;
+
+    case tmrCOMMAND_CHANGE_PERIOD:
+        if (pxMessage->xMessageValue != 0)
+        {
+            pxTimer->xTimerPeriodInTicks = pxMessage->xMessageValue;
+        }
+        prvInsertTimerInActiveList(pxTimer, xTaskGetTickCount() + pxTimer->xTimerPeriodInTicks);
+        break;
+
+    case tmrCOMMAND_DELETE:
+        vPortFree(pxTimer);
+        break;
+
+    case tmrCOMMAND_STOP:
+    default:
+        break;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  定时器服务任务
+ *
+ *  没有定时器要到期时死等命令；否则等命令最多等到最近的到期时间，
+ *  超时返回就说明有定时器到期了
+ *---------------------------------------------------------------------------*/
+static void prvTimerTask(void *pvParameters)
+{
+    TimerCommand_t xMessage;
+    uint32_t xTimeNow;
+    uint32_t xTicksToWait;
+
+    (void)pvParameters;
+
+    for (;;)
+    {
+        /* 先处理到期的定时器，拿到处理完之后的时间 */
+        xTimeNow = prvProcessExpiredTimers();
+
+        /* 算出最多能等多久 */
+        if (xActiveTimerList.uxNumberOfItems == 0)
+        {
+            xTicksToWait = portMAX_DELAY;
+        }
+        else
+        {
+            /* 上面已经处理完到期的，头部一定在未来 */
+            xTicksToWait = xActiveTimerList.xListEnd.pxNext->xItemValue - xTimeNow;
+        }
+
+        /* 等命令，收到一条就把队列里排着的都处理掉 */
+        if (xQueueReceive(xTimerQueue, &xMessage, xTicksToWait) == 0)
+        {
+            do
+            {
+                prvProcessCommand(&xMessage);
+            } while (xQueueReceive(xTimerQueue, &xMessage, 0) == 0);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *  创建定时器服务任务
+ *---------------------------------------------------------------------------*/
+int32_t xTimerCreateTimerTask(void)
+{
+    if (prvCheckForValidListAndQueue() != 0)
+        return -1;
+
+    return xTaskCreate(prvTimerTask,
+                       "Tmr Svc",
+                       configTIMER_TASK_STACK_DEPTH,
+                       NULL,
+                       configTIMER_TASK_PRIORITY,
+                       NULL);
+}
+
+/*---------------------------------------------------------------------------
+ *  查询定时器是否在运行
+ *---------------------------------------------------------------------------*/
+uint32_t xTimerIsTimerActive(TimerHandle_t xTimer)
+{
+    uint32_t xReturn;
+
+    taskENTER_CRITICAL();
+    xReturn = (xTimer->xTimerListItem.pvContainer != NULL) ? 1 : 0;
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/*---------------------------------------------------------------------------
+ *  取定时器 ID
+ *---------------------------------------------------------------------------*/
+void *pvTimerGetTimerID(TimerHandle_t xTimer)
+{
+    return xTimer->pvTimerID;
+}
+
+#endif
\ No newline at end of file
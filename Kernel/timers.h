@@ -0,0 +1,130 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include <stdint.h>
+#include "list.h"
+#include "task.h"
+#include "queue.h"
+
+/*---------------------------------------------------------------------------
+ *  配置宏
+ *---------------------------------------------------------------------------*/
+#define configTIMER_TASK_PRIORITY (MAX_PRIORITIES - 1) /* 定时器服务任务优先级 */
+#define configTIMER_TASK_STACK_DEPTH 256               /* 定时器服务任务栈（字），所有回调共用 */
+#define configTIMER_QUEUE_LENGTH 4                     /* 命令队列长度 */
+
+/* 命令编号 */
+#define tmrCOMMAND_START 0
+#define tmrCOMMAND_STOP 1
+#define tmrCOMMAND_RESET 2
+#define tmrCOMMAND_CHANGE_PERIOD 3
+#define tmrCOMMAND_DELETE 4
+
+/*---------------------------------------------------------------------------
+ *  定时器结构
+ *---------------------------------------------------------------------------*/
+struct TimerDefinition;
+
+/* 回调函数类型，在定时器服务任务里执行，不能阻塞 */
+typedef void (*TimerCallbackFunction_t)(struct TimerDefinition *xTimer);
+
+typedef struct TimerDefinition
+{
+    const char *pcTimerName;                    /* 名字（调试用） */
+    ListItem_t xTimerListItem;                  /* 挂在活动定时器链表上，xItemValue = 到期时间 */
+    uint32_t xTimerPeriodInTicks;               /* 周期（tick） */
+    uint32_t uxAutoReload;                      /* 1：自动重装（周期），0：单次 */
+    void *pvTimerID;                            /* 用户数据，多个定时器共用一个回调时区分 */
+    TimerCallbackFunction_t pxCallbackFunction; /* 到期回调 */
+} Timer_t;
+
+typedef Timer_t *TimerHandle_t;
+
+/*---------------------------------------------------------------------------
+ *  API
+ *---------------------------------------------------------------------------*/
+
+/*
+ * 创建定时器（从堆上分配），创建后处于停止状态
+ *   xTimerPeriodInTicks : 周期（tick，不能为 0）
+ *   uxAutoReload        : 1 自动重装，0 单次
+ *   返回                : 定时器句柄，失败返回 NULL
+ */
+TimerHandle_t xTimerCreate(const char *pcTimerName,
+                           uint32_t xTimerPeriodInTicks,
+                           uint32_t uxAutoReload,
+                           void *pvTimerID,
+                           TimerCallbackFunction_t pxCallbackFunction);
+
+/*
+ * 给定时器服务任务发命令（启动/停止/复位/改周期/删除都走这里）
+ *   xOptionalValue : 改周期时是新周期，其余命令内部填发出命令的 tick
+ *   xTicksToWait   : 命令队列满时最多等多少 tick，
+ *                    在回调里或调度器启动前调用必须是 0
+ *   返回           : 0 命令已发出，-1 命令队列满
+ */
+int32_t xTimerGenericCommand(TimerHandle_t xTimer,
+                             int32_t xCommandID,
+                             uint32_t xOptionalValue,
+                             uint32_t xTicksToWait);
+
+/*
+ * 在中断中发命令，不阻塞
+ *   pxHigherPriorityTaskWoken : 同 xQueueSendFromISR，可以传 NULL
+ */
+int32_t xTimerGenericCommandFromISR(TimerHandle_t xTimer,
+                                    int32_t xCommandID,
+                                    uint32_t xOptionalValue,
+                                    uint32_t *pxHigherPriorityTaskWoken);
+
+/* 启动：从现在开始过一个周期到期，已经在运行的等同于复位 */
+#define xTimerStart(xTimer, xTicksToWait) \
+    xTimerGenericCommand((xTimer), tmrCOMMAND_START, 0, (xTicksToWait))
+
+/* 停止 */
+#define xTimerStop(xTimer, xTicksToWait) \
+    xTimerGenericCommand((xTimer), tmrCOMMAND_STOP, 0, (xTicksToWait))
+
+/* 复位：重新从现在开始计一个周期（看门狗式用法） */
+#define xTimerReset(xTimer, xTicksToWait) \
+    xTimerGenericCommand((xTimer), tmrCOMMAND_RESET, 0, (xTicksToWait))
+
+/* 修改周期，同时启动定时器 */
+#define xTimerChangePeriod(xTimer, xNewPeriod, xTicksToWait) \
+    xTimerGenericCommand((xTimer), tmrCOMMAND_CHANGE_PERIOD, (xNewPeriod), (xTicksToWait))
+
+/* 删除，由服务任务释放内存 */
+#define xTimerDelete(xTimer, xTicksToWait) \
+    xTimerGenericCommand((xTimer), tmrCOMMAND_DELETE, 0, (xTicksToWait))
+
+/* 中断版本，用法同 xQueueSendFromISR */
+#define xTimerStartFromISR(xTimer, pxHigherPriorityTaskWoken) \
+    xTimerGenericCommandFromISR((xTimer), tmrCOMMAND_START, 0, (pxHigherPriorityTaskWoken))
+
+#define xTimerStopFromISR(xTimer, pxHigherPriorityTaskWoken) \
+    xTimerGenericCommandFromISR((xTimer), tmrCOMMAND_STOP, 0, (pxHigherPriorityTaskWoken))
+
+#define xTimerResetFromISR(xTimer, pxHigherPriorityTaskWoken) \
+    xTimerGenericCommandFromISR((xTimer), tmrCOMMAND_RESET, 0, (pxHigherPriorityTaskWoken))
+
+#define xTimerChangePeriodFromISR(xTimer, xNewPeriod, pxHigherPriorityTaskWoken) \
+    xTimerGenericCommandFromISR((xTimer), tmrCOMMAND_CHANGE_PERIOD, (xNewPeriod), (pxHigherPriorityTaskWoken))
+
+/*
+ * 查询定时器是否在运行（在活动链表上）
+ *   返回 : 1 运行中，0 停止
+ */
+uint32_t xTimerIsTimerActive(TimerHandle_t xTimer);
+
+/*
+ * 取创建时传入的 pvTimerID
+ */
+void *pvTimerGetTimerID(TimerHandle_t xTimer);
+
+/*
+ * 创建定时器服务任务和命令队列，vTaskStartScheduler 里调用
+ *   返回 : 0 成功，-1 失败
+ */
+int32_t xTimerCreateTimerTask(void);
+
+#endif
\ No newline at end of file
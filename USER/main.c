@@ -3,6 +3,16 @@
 #include "usart.h"
 #include "task.h"
 #include "heap.h"
+#include "sem.h"
+
+/*
+ * 1：不跑演示任务，改跑内核性能测试，结果从串口打印（单位：CPU 周期，DWT->CYCCNT）
+ * 每项测试重复 BENCH_ROUNDS 次取平均
+ */
+#define DEMO_RUN_BENCHMARK 0
+#define BENCH_ROUNDS       1000
+#define BENCH_DELAY_FILLERS 8 /* 延时插入测试最多挂多少个陪跑的延时任务（受 10KB 堆限制） */
+#define BENCH_DELAY_SAMPLES 16
 
 void Task1(void *param)
 {
@@ -28,6 +38,181 @@ void Task2(void *param)
     vTaskDelete(NULL);
 }
 
+#if DEMO_RUN_BENCHMARK
+static TaskHandle_t xBenchTask = NULL;
+
+/* 打开 DWT 周期计数器 */
+static void prvBenchInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* 任务通知 vs 二值信号量：同一个任务先给再取（不阻塞），比较一对 give/take 的开销 */
+static void prvBenchNotifyVsSemaphore(void)
+{
+    SemaphoreHandle_t xSem = xSemaphoreCreateBinary();
+    uint32_t ulStart, ulNotifyCycles, ulSemCycles;
+    uint32_t i;
+
+    ulStart = DWT->CYCCNT;
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        xTaskNotifyGive(xBenchTask);
+        (void)ulTaskNotifyTake(1, 0);
+    }
+    ulNotifyCycles = DWT->CYCCNT - ulStart;
+
+    ulStart = DWT->CYCCNT;
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        xSemaphoreGive(xSem);
+        xSemaphoreTake(xSem, 0);
+    }
+    ulSemCycles = DWT->CYCCNT - ulStart;
+
+    vSemaphoreDelete(xSem);
+
+    vSafePrintf("[BENCH] notify give+take    : %d cycles\r\n", (int)(ulNotifyCycles / BENCH_ROUNDS));
+    vSafePrintf("[BENCH] semaphore give+take : %d cycles\r\n", (int)(ulSemCycles / BENCH_ROUNDS));
+}
+
+/* 陪跑任务：一直挂在延时时间轮上，唤醒时间各不相同 */
+static void prvDelayFillerTask(void *param)
+{
+    for (;;) {
+        vTaskDelay(100000 + (uint32_t)param);
+    }
+}
+
+/*
+ * 延时插入耗时 vs 时间轮上的任务数：
+ * 临界区里调用 vTaskDelay，PendSV 被 BASEPRI 挡住，测到的只是移出就绪链表 + 插入时间轮，
+ * 退出临界区后才真正切走
+ */
+static void prvBenchDelayInsert(void)
+{
+    TaskHandle_t xFillers[BENCH_DELAY_FILLERS];
+    uint32_t ulStart, ulCycles;
+    uint32_t uxFillers = 0;
+    uint32_t i;
+
+    for (;;) {
+        ulCycles = 0;
+        for (i = 0; i < BENCH_DELAY_SAMPLES; i++) {
+            taskENTER_CRITICAL();
+            ulStart = DWT->CYCCNT;
+            vTaskDelay(2);
+            ulCycles += DWT->CYCCNT - ulStart;
+            taskEXIT_CRITICAL();
+        }
+
+        vSafePrintf("[BENCH] delay insert, %d delayed tasks : %d cycles\r\n",
+                    (int)uxFillers, (int)(ulCycles / BENCH_DELAY_SAMPLES));
+
+        if (uxFillers >= BENCH_DELAY_FILLERS)
+            break;
+
+        /* 再加 4 个：优先级比自己高，创建后马上运行并挂到时间轮上 */
+        for (i = 0; i < 4 && uxFillers < BENCH_DELAY_FILLERS; i++, uxFillers++) {
+            xTaskCreate(prvDelayFillerTask, "Filler", TASK_STACK_MIN,
+                        (void *)(uxFillers * 7), 3, &xFillers[uxFillers]);
+        }
+    }
+
+    for (i = 0; i < uxFillers; i++) {
+        vTaskDelete(xFillers[i]);
+    }
+}
+
+/*
+ * 任务切换耗时：两个同优先级任务互相 taskYIELD，
+ * A 记下让出前的 CYCCNT，B 从 taskYIELD 返回时算差值，包括 PendSV 保存/恢复和选任务。
+ * xSwitchUseFpu 为 1 时两个任务每轮都做一次浮点运算，PendSV 要多存 S16~S31（FPU 帧）
+ */
+static volatile uint32_t ulSwitchStart;
+static volatile uint32_t xSwitchArmed;
+static volatile uint32_t ulSwitchTotal;
+static volatile uint32_t ulSwitchMin;
+static volatile uint32_t ulSwitchCount;
+static volatile uint32_t xSwitchUseFpu;
+static volatile float fSwitchScratch;
+
+static void prvSwitchTaskA(void *param)
+{
+    uint32_t i;
+
+    (void)param;
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        if (xSwitchUseFpu)
+            fSwitchScratch += 1.0f;
+        xSwitchArmed = 1;
+        ulSwitchStart = DWT->CYCCNT;
+        taskYIELD();
+    }
+    vTaskDelete(NULL);
+}
+
+static void prvSwitchTaskB(void *param)
+{
+    uint32_t ulCycles;
+
+    (void)param;
+    /* 第一次切到 B 是从任务入口开始跑的，不算，所以只量 BENCH_ROUNDS - 1 次 */
+    while (ulSwitchCount < BENCH_ROUNDS - 1) {
+        if (xSwitchUseFpu)
+            fSwitchScratch += 1.0f;
+        taskYIELD();
+        if (xSwitchArmed) {
+            ulCycles = DWT->CYCCNT - ulSwitchStart;
+            xSwitchArmed = 0;
+            ulSwitchTotal += ulCycles;
+            if (ulCycles < ulSwitchMin)
+                ulSwitchMin = ulCycles;
+            ulSwitchCount++;
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+static void prvBenchContextSwitch(uint32_t xUseFpu)
+{
+    ulSwitchTotal = 0;
+    ulSwitchMin = 0xFFFFFFFFUL;
+    ulSwitchCount = 0;
+    xSwitchArmed = 0;
+    xSwitchUseFpu = xUseFpu;
+
+    /* 两个都建好再一起开跑：优先级比自己高，临界区里 PendSV 被挡住 */
+    taskENTER_CRITICAL();
+    xTaskCreate(prvSwitchTaskA, "SwA", TASK_STACK_MIN, NULL, 3, NULL);
+    xTaskCreate(prvSwitchTaskB, "SwB", TASK_STACK_MIN, NULL, 3, NULL);
+    taskEXIT_CRITICAL();
+
+    /* 回到这里时两个任务都已经删掉了 */
+    vSafePrintf("[BENCH] context switch (%s frame) : avg %d, min %d cycles\r\n",
+                xUseFpu ? "FPU" : "short",
+                (int)(ulSwitchTotal / ulSwitchCount), (int)ulSwitchMin);
+
+    /* 让空闲任务回收两个测试任务的内存 */
+    vTaskDelay(10);
+}
+
+void BenchTask(void *param)
+{
+    (void)param;
+
+    prvBenchInit();
+
+    prvBenchNotifyVsSemaphore();
+    prvBenchDelayInsert();
+    prvBenchContextSwitch(0);
+    prvBenchContextSwitch(1);
+
+    vSafePrintf("[BENCH] done\r\n");
+    vTaskDelete(NULL);
+}
+#endif
+
 int main(void)
 {
     UART_Init(115200);
@@ -39,8 +224,12 @@ int main(void)
 
     printf("Heap free: %d\r\n", (int)xPortGetFreeHeapSize());
 
+#if DEMO_RUN_BENCHMARK
+    xTaskCreate(BenchTask, "Bench", 256, NULL, 2, &xBenchTask);
+#else
     xTaskCreate(Task1, "Task1", 256, NULL, 1, NULL);
     xTaskCreate(Task2, "Task2", 256, NULL, 1, NULL);
+#endif
 
     printf("After create, Heap free: %d\r\n\r\n", (int)xPortGetFreeHeapSize());
 